@@ -0,0 +1,75 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Backend {
+
+	/*
+	 * Owns every AST node of one compilation.
+	 * Nodes are bump-allocated from large blocks and all freed together when the arena goes away,
+	 * so it has to outlive the parse and the compile that reads the tree.
+	 * Nodes point at each other with plain pointers, none of them is freed on its own.
+	 * It also keeps the lexemes that are not in the source, see keep().
+	 */
+	class AstArena {
+	public:
+		AstArena() = default;
+		AstArena(const AstArena &) = delete;
+		AstArena &operator=(const AstArena &) = delete;
+
+		~AstArena() {
+			// Newest first, a node never refers to one made after it
+			for (auto it = destructors.rbegin(); it != destructors.rend(); ++it)
+				it->destroy(it->object);
+		}
+
+		template<typename T, typename... Args>
+		T *make(Args &&...args) {
+			T *node = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+			if constexpr (!std::is_trivially_destructible_v<T>)
+				destructors.push_back({node, [](void *object) { static_cast<T *>(object)->~T(); }});
+			return node;
+		}
+
+		// A copy of text that lives as long as the nodes: escaped strings, namespaced names, folded constants
+		std::string_view keep(std::string_view text) {
+			char *copy = static_cast<char *>(allocate(text.size(), 1));
+			std::memcpy(copy, text.data(), text.size());
+			return {copy, text.size()};
+		}
+
+	private:
+		static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+		struct Destructor {
+			void *object;
+			void (*destroy)(void *);
+		};
+
+		std::vector<std::unique_ptr<std::byte[]>> blocks;
+		std::vector<Destructor> destructors; // Nodes with vectors or optionals still need their destructor run
+		std::byte *next = nullptr; // Free space left in the newest block
+		size_t left = 0;
+
+		void *allocate(size_t size, size_t align) {
+			size_t padding = (align - reinterpret_cast<uintptr_t>(next) % align) % align;
+			if (next == nullptr || padding + size > left) {
+				size_t blockSize = size + align > BLOCK_SIZE ? size + align : BLOCK_SIZE;
+				blocks.push_back(std::make_unique<std::byte[]>(blockSize));
+				next = blocks.back().get();
+				left = blockSize;
+				padding = (align - reinterpret_cast<uintptr_t>(next) % align) % align;
+			}
+			void *result = next + padding;
+			next += padding + size;
+			left -= padding + size;
+			return result;
+		}
+	};
+} // namespace Backend
@@ -23,7 +23,7 @@ namespace Backend {
 	public:
 		Environment() : enclosing() {}
 		Environment(std::shared_ptr<Environment> enclosing) : enclosing(enclosing) {}
-		RyValue get(const Token &name) { return get(name.lexeme, name); }
+		RyValue get(const Token &name) { return get(std::string(name.lexeme), name); }
 		RyValue get(const std::string &name, const Token &errorToken);
 		void define(const std::string &name, RyVariable value);
 		void define(const std::string &name, RyValue value, bool isPrivate = false);
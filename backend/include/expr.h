@@ -42,33 +42,33 @@ namespace Backend {
 		void accept(ExprVisitor &visitor) override { visitor.visitValue(*this); }
 	};
 	struct MathExpr : public Expr {
-		std::shared_ptr<Expr> left;
+		Expr *left;
 		Token op_t;
-		std::shared_ptr<Expr> right;
+		Expr *right;
 
-		MathExpr(std::shared_ptr<Expr> l, Token op, std::shared_ptr<Expr> r) :
-				left(std::move(l)), op_t(std::move(op)), right(std::move(r)) {}
+		MathExpr(Expr *l, Token op, Expr *r) :
+				left(l), op_t(std::move(op)), right(r) {}
 
 		void accept(ExprVisitor &visitor) override { visitor.visitMath(*this); }
 	};
 	struct GroupExpr : public Expr {
-		std::shared_ptr<Expr> expression;
+		Expr *expression;
 
-		explicit GroupExpr(std::shared_ptr<Expr> e) : expression(std::move(e)) {}
+		explicit GroupExpr(Expr *e) : expression(e) {}
 
 		void accept(ExprVisitor &visitor) override { visitor.visitGroup(*this); }
 	};
 	struct PrefixExpr : public Expr {
 		Token prefix;
-		std::shared_ptr<Expr> right;
+		Expr *right;
 
-		explicit PrefixExpr(Token p, std::shared_ptr<Expr> r) : prefix(std::move(p)), right(std::move(r)) {}
+		explicit PrefixExpr(Token p, Expr *r) : prefix(std::move(p)), right(r) {}
 		void accept(ExprVisitor &visitor) override { visitor.visitPrefix(*this); }
 	};
 	struct PostfixExpr : public Expr {
 		Token postfix;
-		std::shared_ptr<Expr> left;
-		explicit PostfixExpr(Token p, std::shared_ptr<Expr> l) : postfix(std::move(p)), left(std::move(l)) {}
+		Expr *left;
+		explicit PostfixExpr(Token p, Expr *l) : postfix(std::move(p)), left(l) {}
 		void accept(ExprVisitor &visitor) override { visitor.visitPostfix(*this); }
 	};
 	struct VariableExpr : public Expr {
@@ -78,115 +78,115 @@ namespace Backend {
 	};
 	struct AssignExpr : public Expr {
 		Token name;
-		std::shared_ptr<Expr> value;
-		AssignExpr(Token n, std::shared_ptr<Expr> v) : name(std::move(n)), value(std::move(v)) {}
+		Expr *value;
+		AssignExpr(Token n, Expr *v) : name(std::move(n)), value(v) {}
 		void accept(ExprVisitor &visitor) override { visitor.visitAssign(*this); }
 	};
 	struct LogicalExpr : public Expr {
-		std::shared_ptr<Expr> left;
+		Expr *left;
 		Token op_t;
-		std::shared_ptr<Expr> right;
-		LogicalExpr(std::shared_ptr<Expr> l, Token op, std::shared_ptr<Expr> r) :
-				left(std::move(l)), op_t(std::move(op)), right(std::move(r)) {}
+		Expr *right;
+		LogicalExpr(Expr *l, Token op, Expr *r) :
+				left(l), op_t(std::move(op)), right(r) {}
 		void accept(ExprVisitor &visitor) override { visitor.visitLogical(*this); }
 	};
 	struct CallExpr : public Expr {
-		std::shared_ptr<Expr> callee;
-		std::vector<std::shared_ptr<Expr>> arguments;
+		Expr *callee;
+		std::vector<Expr *> arguments;
 		Token Paren;
-		CallExpr(std::shared_ptr<Expr> c, std::vector<std::shared_ptr<Expr>> args, Token p) :
-				callee(std::move(c)), arguments(std::move(args)), Paren(std::move(p)) {}
+		CallExpr(Expr *c, std::vector<Expr *> args, Token p) :
+				callee(c), arguments(std::move(args)), Paren(std::move(p)) {}
 		void accept(ExprVisitor &visitor) override { visitor.visitCall(*this); }
 	};
 	struct ListExpr : public Expr {
-		std::vector<std::shared_ptr<Expr>> elements;
-		ListExpr(std::vector<std::shared_ptr<Expr>> elements) : elements(std::move(elements)) {}
+		std::vector<Expr *> elements;
+		ListExpr(std::vector<Expr *> elements) : elements(std::move(elements)) {}
 		void accept(ExprVisitor &visitor) override { visitor.visitList(*this); }
 	};
 
 	struct IndexExpr : public Expr {
-		std::shared_ptr<Expr> object;
-		std::shared_ptr<Expr> index;
+		Expr *object;
+		Expr *index;
 		Token bracket;
-		IndexExpr(std::shared_ptr<Expr> o, std::shared_ptr<Expr> i, Token b) :
-				object(std::move(o)), index(std::move(i)), bracket(std::move(b)) {}
+		IndexExpr(Expr *o, Expr *i, Token b) :
+				object(o), index(i), bracket(std::move(b)) {}
 		void accept(ExprVisitor &visitor) override { visitor.visitIndex(*this); }
 	};
 
 	struct GetExpr : public Expr {
-		std::shared_ptr<Expr> object;
+		Expr *object;
 		Token name;
-		GetExpr(std::shared_ptr<Expr> o, Token n) : object(std::move(o)), name(std::move(n)) {}
+		GetExpr(Expr *o, Token n) : object(o), name(std::move(n)) {}
 		void accept(ExprVisitor &visitor) override { visitor.visitGet(*this); }
 	};
 
 	struct SetExpr : public Expr {
-		std::shared_ptr<Expr> object;
+		Expr *object;
 		Token name;
-		std::shared_ptr<Expr> value;
-		SetExpr(std::shared_ptr<Expr> o, Token n, std::shared_ptr<Expr> v) :
-				object(std::move(o)), name(std::move(n)), value(std::move(v)) {}
+		Expr *value;
+		SetExpr(Expr *o, Token n, Expr *v) :
+				object(o), name(std::move(n)), value(v) {}
 		void accept(ExprVisitor &visitor) override { visitor.visitSet(*this); }
 	};
 	struct MapExpr : public Expr {
 		Token braceToken;
 		// A vector of pairs: first is the Key expression, second is the Value expression
-		std::vector<std::pair<std::shared_ptr<Expr>, std::shared_ptr<Expr>>> items;
+		std::vector<std::pair<Expr *, Expr *>> items;
 
-		MapExpr(Token braceTok, std::vector<std::pair<std::shared_ptr<Expr>, std::shared_ptr<Expr>>> items) :
+		MapExpr(Token braceTok, std::vector<std::pair<Expr *, Expr *>> items) :
 				braceToken(std::move(braceTok)), items(std::move(items)) {}
 
 		void accept(ExprVisitor &visitor) override { visitor.visitMap(*this); }
 	};
 	struct IndexSetExpr : public Expr {
-		std::shared_ptr<Expr> object;
+		Expr *object;
 		Token bracket;
-		std::shared_ptr<Expr> index;
-		std::shared_ptr<Expr> value;
+		Expr *index;
+		Expr *value;
 
-		IndexSetExpr(std::shared_ptr<Expr> object, Token bracket, std::shared_ptr<Expr> index,
-								 std::shared_ptr<Expr> value) : object(object), bracket(bracket), index(index), value(value) {}
+		IndexSetExpr(Expr *object, Token bracket, Expr *index,
+								 Expr *value) : object(object), bracket(bracket), index(index), value(value) {}
 
 		void accept(ExprVisitor &visitor) override { visitor.visitIndexSet(*this); }
 	};
 	struct RangeExpr : public Expr {
-		std::shared_ptr<Expr> leftBound;
+		Expr *leftBound;
 		Token op_t;
-		std::shared_ptr<Expr> rightBound;
-		RangeExpr(std::shared_ptr<Expr> l, Token op, std::shared_ptr<Expr> r) :
-				leftBound(std::move(l)), op_t(std::move(op)), rightBound(std::move(r)) {}
+		Expr *rightBound;
+		RangeExpr(Expr *l, Token op, Expr *r) :
+				leftBound(l), op_t(std::move(op)), rightBound(r) {}
 		void accept(ExprVisitor &visitor) override { visitor.visitRange(*this); }
 	};
 	struct BitwiseAndExpr : public Expr {
-		std::shared_ptr<Expr> left;
+		Expr *left;
 		Token op_t;
-		std::shared_ptr<Expr> right;
-		BitwiseAndExpr(std::shared_ptr<Expr> l, Token op, std::shared_ptr<Expr> r) :
-				left(std::move(l)), op_t(std::move(op)), right(std::move(r)) {}
+		Expr *right;
+		BitwiseAndExpr(Expr *l, Token op, Expr *r) :
+				left(l), op_t(std::move(op)), right(r) {}
 		void accept(ExprVisitor &visitor) override { visitor.visitBitwiseAnd(*this); }
 	};
 	struct BitwiseOrExpr : public Expr {
-		std::shared_ptr<Expr> left;
+		Expr *left;
 		Token op_t;
-		std::shared_ptr<Expr> right;
-		BitwiseOrExpr(std::shared_ptr<Expr> l, Token op, std::shared_ptr<Expr> r) :
-				left(std::move(l)), op_t(std::move(op)), right(std::move(r)) {}
+		Expr *right;
+		BitwiseOrExpr(Expr *l, Token op, Expr *r) :
+				left(l), op_t(std::move(op)), right(r) {}
 		void accept(ExprVisitor &visitor) override { visitor.visitBitwiseOr(*this); }
 	};
 	struct BitwiseXorExpr : public Expr {
-		std::shared_ptr<Expr> left;
+		Expr *left;
 		Token op_t;
-		std::shared_ptr<Expr> right;
-		BitwiseXorExpr(std::shared_ptr<Expr> l, Token op, std::shared_ptr<Expr> r) :
-				left(std::move(l)), op_t(std::move(op)), right(std::move(r)) {}
+		Expr *right;
+		BitwiseXorExpr(Expr *l, Token op, Expr *r) :
+				left(l), op_t(std::move(op)), right(r) {}
 		void accept(ExprVisitor &visitor) override { visitor.visitBitwiseXor(*this); }
 	};
 	struct ShiftExpr : public Expr {
-		std::shared_ptr<Expr> left;
+		Expr *left;
 		Token op_t;
-		std::shared_ptr<Expr> right;
-		ShiftExpr(std::shared_ptr<Expr> l, Token op, std::shared_ptr<Expr> r) :
-				left(std::move(l)), op_t(std::move(op)), right(std::move(r)) {}
+		Expr *right;
+		ShiftExpr(Expr *l, Token op, Expr *r) :
+				left(l), op_t(std::move(op)), right(r) {}
 		void accept(ExprVisitor &visitor) override { visitor.visitShift(*this); }
 	};
 	struct ThisExpr  : public Expr {
@@ -3,26 +3,36 @@
 //
 
 #pragma once
+#include <deque>
+#include <string_view>
 #include <vector>
+#include "arena.h"
 #include "value.h"
 #include "token.h"
 
 namespace Backend {
 
+	/*
+	 * Turns source into tokens one at a time, see nextToken().
+	 * Lexemes are views of the source, nothing is copied per token,
+	 * so the source has to outlive the lexer and every token it produced.
+	 * A string with escapes is copied into the arena, which has to outlive the tokens as well.
+	 */
 	class Lexer {
 	public:
-		Lexer(std::string src) : source(std::move(src)){};
+		Lexer(std::string_view src, AstArena &arena) : source(src), arena(arena) {}
 		~Lexer() = default;
-		[[nodiscard]] std::vector<Token> getTokens() const;
-		std::vector<Token> scanTokens();
+		Token nextToken(); // Keeps returning EOF_TOKEN once the source is exhausted
+		std::vector<Token> scanTokens(); // Every token up to and including EOF_TOKEN
 
 	private:
-		std::string source;
-		std::vector<Token> tokens;
+		std::string_view source;
+		AstArena &arena;
+		std::deque<Token> pending; // Scanned but not yet returned, an interpolated string yields several
 
 		// Position
-		int start = 0;
-		int current = 0;
+		size_t start = 0;
+		size_t current = 0;
 		int line = 1;
 		int column = 1;
 		int tokenStartColumn = 1;
@@ -5,7 +5,9 @@
 #pragma once
 #include <set>
 #include <vector>
+#include "arena.h"
 #include "expr.h"
+#include "lexer.h"
 #include "stmt.h"
 #include "token.h"
 
@@ -13,74 +15,84 @@ namespace Backend {
 
 	class Parser {
 	public:
-		Parser(const std::vector<Token> &tokens, std::set<std::string> &aliases, std::string sc) :
-				tokens(tokens), externalTypeAliases(aliases), sourceCode(std::move(sc)) {}
+		// Pulls tokens from lexer as it goes, so the source is lexed and parsed in one pass.
+		// The nodes are allocated in arena, which has to outlive the compile of the returned statements
+		Parser(Lexer &lexer, AstArena &arena, std::set<std::string, std::less<>> &aliases, std::string sc) :
+				externalTypeAliases(aliases), sourceCode(std::move(sc)), lexer(lexer), arena(arena) {}
 		~Parser() = default;
-		std::set<std::string> &externalTypeAliases;
-		std::vector<std::shared_ptr<Stmt>> parse();
+		std::set<std::string, std::less<>> &externalTypeAliases;
+		std::vector<Stmt *> parse();
 
 	private:
 		int loopDepth = 0;
 		std::string sourceCode;
-		std::vector<Token> tokens;
+		Lexer &lexer;
+		AstArena &arena;
+		// The last WINDOW tokens pulled from the lexer, position i lives in tokens[i % WINDOW].
+		// The parser looks at most one token back and three ahead, so a slot is only reused long after
+		static const int WINDOW = 8;
+		Token tokens[WINDOW];
+		int pulled = 0; // How many tokens the lexer has produced
 
 		// Position
 		int current = 0;
-		std::set<std::string> typeAliases;
-		Token peek();
-		Token next();
-		bool isTypeAlias(std::string const &name);
-		bool isTypeAlias(std::shared_ptr<Expr> expr);
-		Token previous();
-		Token consume(TokenType type, const std::string &message);
+		std::set<std::string, std::less<>> typeAliases;
+		const Token &tokenAt(int index); // Lexes up to index if needed, EOF_TOKEN past the end
+		// The token accessors return references into the window, copy a token to keep it past the next few tokens
+		const Token &peek();
+		const Token &next();
+		bool isTypeAlias(std::string_view name);
+		bool isTypeAlias(Expr *expr);
+		const Token &previous();
+		const Token &consume(TokenType type, const std::string &message);
 		std::string currentNamespace = "";
-		static std::set<std::string> namespaces;
+		static std::set<std::string, std::less<>> namespaces;
 		bool check(TokenType type);
-		[[nodiscard]] bool checkNext(TokenType type) const;
-		[[nodiscard]] bool isAtEnd() const;
+		[[nodiscard]] bool checkNext(TokenType type);
+		[[nodiscard]] bool isAtEnd();
 		bool match(std::initializer_list<TokenType> types);
 		void error(const Token &token, const std::string &message);
 
 		// Expression
-		std::shared_ptr<Expr> expression();
-		std::shared_ptr<Expr> assignment();
-		std::shared_ptr<Expr> logicalOr();
-		std::shared_ptr<Expr> logicalAnd();
-		std::shared_ptr<Expr> equality();
-		std::shared_ptr<Expr> comparison();
-		std::shared_ptr<Expr> range();
-		std::shared_ptr<Expr> shift();
-		std::shared_ptr<Expr> bitwiseOr();
-		std::shared_ptr<Expr> bitwiseXor();
-		std::shared_ptr<Expr> bitwiseAnd();
-		std::shared_ptr<Expr> addition();
-		std::shared_ptr<Expr> multiplication();
-		std::shared_ptr<Expr> baseValue();
-		std::shared_ptr<Expr> prefixed();
-		std::shared_ptr<Expr> postfixed();
-		std::shared_ptr<Expr> finishCall(std::shared_ptr<Expr> callee);
+		Expr *expression();
+		Expr *assignment();
+		Expr *logicalOr();
+		Expr *logicalAnd();
+		Expr *equality();
+		Expr *comparison();
+		Expr *range();
+		Expr *shift();
+		Expr *bitwiseOr();
+		Expr *bitwiseXor();
+		Expr *bitwiseAnd();
+		Expr *addition();
+		Expr *multiplication();
+		Expr *baseValue();
+		Expr *prefixed();
+		Expr *postfixed();
+		Expr *finishCall(Expr *callee);
 
 		// Statements
-		std::shared_ptr<Stmt> forStatement();
-		std::shared_ptr<Stmt> eachStatement();
-		std::shared_ptr<Stmt> statement();
-		std::shared_ptr<Stmt> declaration();
-		std::shared_ptr<Stmt> whileStatement();
-		std::shared_ptr<FunctionStmt> functionDeclaration(const std::string &kind);
-		std::shared_ptr<Stmt> ImportDeclaration();
-		std::shared_ptr<Stmt> AliasDeclaration();
-		std::shared_ptr<VarStmt> typeDeclaration(std::optional<Token> prefix = std::nullopt, bool isPrivate = false);
-		std::shared_ptr<Stmt> expressionStatement();
-		std::shared_ptr<Stmt> returnStatement();
-		std::shared_ptr<Stmt> ifStatement();
-		std::shared_ptr<Stmt> unlessStatement();
-		std::shared_ptr<Stmt> untilStatement();
-		std::shared_ptr<Stmt> namespaceStatement();
-		std::shared_ptr<Stmt> classStatement();
-		std::shared_ptr<Stmt> attemptStatement();
-		std::shared_ptr<Stmt> panicStatement();
+		Stmt *forStatement();
+		Stmt *eachStatement();
+		Stmt *statement();
+		Stmt *declaration();
+		Stmt *whileStatement();
+		FunctionStmt *functionDeclaration(const std::string &kind);
+		Stmt *ImportDeclaration();
+		Stmt *AliasDeclaration();
+		VarStmt *typeDeclaration(std::optional<Token> prefix = std::nullopt, bool isPrivate = false);
+		Stmt *expressionStatement();
+		Stmt *returnStatement();
+		Stmt *ifStatement();
+		Stmt *unlessStatement();
+		Stmt *untilStatement();
+		Stmt *namespaceStatement();
+		Stmt *classStatement();
+		Stmt *attemptStatement();
+		Stmt *panicStatement();
 
-		std::vector<std::shared_ptr<Stmt>> block();
+		std::vector<Stmt *> block();
 	};
 
 } // namespace Backend
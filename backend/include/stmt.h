@@ -14,7 +14,7 @@ namespace Backend {
 	struct Parameter {
 		Token name;
 		Token type;
-		std::shared_ptr<Expr> defaultValue;
+		Expr *defaultValue;
 	};
 
 	struct ExpressionStmt;
@@ -37,7 +37,7 @@ namespace Backend {
 	struct PanicStmt;
 
 
-	struct Stmt : public std::enable_shared_from_this<Stmt> {
+	struct Stmt {
 		virtual ~Stmt() = default;
 		virtual void accept(StmtVisitor &visitor) = 0;
 	};
@@ -65,8 +65,8 @@ namespace Backend {
 
 
 	struct ExpressionStmt : public Stmt {
-		std::shared_ptr<Expr> expression;
-		explicit ExpressionStmt(std::shared_ptr<Expr> expr) : expression(std::move(expr)) {}
+		Expr *expression;
+		explicit ExpressionStmt(Expr *expr) : expression(expr) {}
 
 		void accept(StmtVisitor &visitor) override { visitor.visitExpressionStmt(*this); }
 	};
@@ -75,13 +75,13 @@ namespace Backend {
 		Token name;
 
 		std::vector<Parameter> parameters;
-		std::vector<std::shared_ptr<Stmt>> body;
+		std::vector<Stmt *> body;
 		std::optional<Token> returnTypeNamespace;
 		std::optional<Token> returnTypeAlias;
 		bool isPrivate = false; // member for Classes
 
 
-		FunctionStmt(Token n, std::vector<Parameter> p, std::vector<std::shared_ptr<Stmt>> b, std::optional<Token> rTypeNs,
+		FunctionStmt(Token n, std::vector<Parameter> p, std::vector<Stmt *> b, std::optional<Token> rTypeNs,
 								 std::optional<Token> rTypeAlias) :
 				name(std::move(n)), parameters(std::move(p)), body(std::move(b)), returnTypeNamespace(std::move(rTypeNs)),
 				returnTypeAlias(std::move(rTypeAlias)) {}
@@ -89,17 +89,17 @@ namespace Backend {
 	};
 
 	struct ImportStmt : public Stmt {
-		std::shared_ptr<Expr> module;
+		Expr *module;
 
-		explicit ImportStmt(std::shared_ptr<Expr> m) : module(std::move(m)) {}
+		explicit ImportStmt(Expr *m) : module(m) {}
 		void accept(StmtVisitor &visitor) override { visitor.visitImportStmt(*this); }
 	};
 
 	struct AliasStmt : public Stmt {
-		std::shared_ptr<Expr> aliasExpr;
+		Expr *aliasExpr;
 		Token name;
 
-		AliasStmt(std::shared_ptr<Expr> a, Token n) : name(n), aliasExpr(std::move(a)) {}
+		AliasStmt(Expr *a, Token n) : aliasExpr(a), name(n) {}
 		void accept(StmtVisitor &visitor) override { visitor.visitAliasStmt(*this); }
 	};
 
@@ -107,71 +107,71 @@ namespace Backend {
 		Token type; // can be a type alias or 'data'
 		std::optional<Token> innerType; // data type
 		Token name; // variable name
-		std::shared_ptr<Expr> initializer; // variable data
+		Expr *initializer; // variable data
 		bool isPrivate = false; // member for Classes
 
 
-		VarStmt(Token type, std::optional<Token> innerType, Token name, std::shared_ptr<Expr> initializer,
+		VarStmt(Token type, std::optional<Token> innerType, Token name, Expr *initializer,
 						bool isPrivate = false) :
 				type(std::move(type)), innerType(std::move(innerType)), name(std::move(name)),
-				initializer(std::move(initializer)), isPrivate(isPrivate) {}
+				initializer(initializer), isPrivate(isPrivate) {}
 
 		void accept(StmtVisitor &visitor) override { visitor.visitVarStmt(*this); }
 	};
 
 	struct ReturnStmt : public Stmt {
 		Token keyword;
-		std::shared_ptr<Expr> value; // Can be nullptr for 'return;'
+		Expr *value; // Can be nullptr for 'return;'
 
-		ReturnStmt(Token keyword, std::shared_ptr<Expr> value) : keyword(std::move(keyword)), value(std::move(value)) {}
+		ReturnStmt(Token keyword, Expr *value) : keyword(std::move(keyword)), value(value) {}
 
 		void accept(StmtVisitor &visitor) override { visitor.visitReturnStmt(*this); }
 	};
 
 	struct IfStmt : public Stmt {
-		std::shared_ptr<Expr> condition;
-		std::shared_ptr<Stmt> thenBranch;
-		std::shared_ptr<Stmt> elseBranch; // Can be nullptr
+		Expr *condition;
+		Stmt *thenBranch;
+		Stmt *elseBranch; // Can be nullptr
 
-		IfStmt(std::shared_ptr<Expr> condition, std::shared_ptr<Stmt> thenBranch, std::shared_ptr<Stmt> elseBranch) :
-				condition(std::move(condition)), thenBranch(std::move(thenBranch)), elseBranch(std::move(elseBranch)) {}
+		IfStmt(Expr *condition, Stmt *thenBranch, Stmt *elseBranch) :
+				condition(condition), thenBranch(thenBranch), elseBranch(elseBranch) {}
 
 		void accept(StmtVisitor &visitor) override { visitor.visitIfStmt(*this); }
 	};
 
 	struct WhileStmt : public Stmt {
-		std::shared_ptr<Expr> condition;
-		std::shared_ptr<Stmt> body;
+		Expr *condition;
+		Stmt *body;
 
-		WhileStmt(std::shared_ptr<Expr> condition, std::shared_ptr<Stmt> body) :
-				condition(std::move(condition)), body(std::move(body)) {}
+		WhileStmt(Expr *condition, Stmt *body) :
+				condition(condition), body(body) {}
 
 		void accept(StmtVisitor &visitor) override { visitor.visitWhileStmt(*this); }
 	};
 
 	struct BlockStmt : public Stmt {
-		std::vector<std::shared_ptr<Stmt>> statements;
+		std::vector<Stmt *> statements;
 
-		BlockStmt(std::vector<std::shared_ptr<Stmt>> statements) : statements(std::move(statements)) {}
+		BlockStmt(std::vector<Stmt *> statements) : statements(std::move(statements)) {}
 
 		void accept(StmtVisitor &visitor) override { visitor.visitBlockStmt(*this); }
 	};
 
 	struct NamespaceStmt : public Stmt {
 		Token name;
-		std::vector<std::shared_ptr<Stmt>> body;
+		std::vector<Stmt *> body;
 
-		NamespaceStmt(Token n, std::vector<std::shared_ptr<Stmt>> b) : name(std::move(n)), body(std::move(b)) {}
+		NamespaceStmt(Token n, std::vector<Stmt *> b) : name(std::move(n)), body(std::move(b)) {}
 		void accept(StmtVisitor &visitor) override { visitor.visitNamespaceStmt(*this); }
 	};
 	struct EachStmt : public Stmt {
 		Token id;
 		std::optional<Token> dataType = std::nullopt;
-		std::shared_ptr<Expr> collection;
-		std::shared_ptr<Stmt> body;
-		EachStmt(Token id, std::shared_ptr<Expr> collection, std::shared_ptr<Stmt> body,
+		Expr *collection;
+		Stmt *body;
+		EachStmt(Token id, Expr *collection, Stmt *body,
 						 std::optional<Token> dataType = std::nullopt) :
-				id(std::move(id)), collection(std::move(collection)), body(std::move(body)), dataType(std::move(dataType)) {}
+				id(std::move(id)), dataType(std::move(dataType)), collection(collection), body(body) {}
 		void accept(StmtVisitor &visitor) override { visitor.visitEachStmt(*this); }
 	};
 	struct StopStmt : public Stmt {
@@ -186,14 +186,14 @@ namespace Backend {
 		void accept(StmtVisitor &visitor) override { visitor.visitSkipStmt(*this); }
 	};
 	struct ForStmt : public Stmt {
-		std::shared_ptr<Stmt> init;
-		std::shared_ptr<Expr> condition;
-		std::shared_ptr<Expr> increment;
-		std::shared_ptr<Stmt> body;
-
-		ForStmt(std::shared_ptr<Stmt> init, std::shared_ptr<Expr> condition, std::shared_ptr<Expr> increment,
-						std::shared_ptr<Stmt> body) :
-				init(std::move(init)), condition(std::move(condition)), increment(std::move(increment)), body(std::move(body)) {
+		Stmt *init;
+		Expr *condition;
+		Expr *increment;
+		Stmt *body;
+
+		ForStmt(Stmt *init, Expr *condition, Expr *increment,
+						Stmt *body) :
+				init(init), condition(condition), increment(increment), body(body) {
 		}
 
 		void accept(StmtVisitor &visitor) override { visitor.visitForStmt(*this); }
@@ -201,35 +201,35 @@ namespace Backend {
 	class ClassStmt : public Stmt {
 	public:
 		Token name;
-		std::vector<std::shared_ptr<FunctionStmt>> methods;
-		std::vector<std::shared_ptr<VarStmt>> fields;
-		std::shared_ptr<VariableExpr> superclass = nullptr;
+		std::vector<FunctionStmt *> methods;
+		std::vector<VarStmt *> fields;
+		VariableExpr *superclass = nullptr;
 		bool isPrivate = false;
 
-		ClassStmt(Token name, std::vector<std::shared_ptr<FunctionStmt>> methods,
-							std::vector<std::shared_ptr<VarStmt>> fields, bool isPrivate,
-							std::shared_ptr<VariableExpr> superclass = nullptr) :
-				name(name), methods(std::move(methods)), fields(std::move(fields)), isPrivate(isPrivate),
-				superclass(std::move(superclass)) {}
+		ClassStmt(Token name, std::vector<FunctionStmt *> methods,
+							std::vector<VarStmt *> fields, bool isPrivate,
+							VariableExpr *superclass = nullptr) :
+				name(name), methods(std::move(methods)), fields(std::move(fields)), superclass(superclass),
+				isPrivate(isPrivate) {}
 		void accept(StmtVisitor &visitor) override { visitor.visitClassStmt(*this); }
 	};
 	struct AttemptStmt : public Stmt {
-		std::vector<std::shared_ptr<Stmt>> attemptBody;
-		std::vector<std::shared_ptr<Stmt>> failBody;
+		std::vector<Stmt *> attemptBody;
+		std::vector<Stmt *> failBody;
 		Token errorType;
 		Token error;
-		std::vector<std::shared_ptr<Stmt>> finallyBody;
+		std::vector<Stmt *> finallyBody;
 
-		AttemptStmt(std::vector<std::shared_ptr<Stmt>> aBody, std::vector<std::shared_ptr<Stmt>> fBody, Token e,
-								std::vector<std::shared_ptr<Stmt>> fiBody, Token errorType) :
-				attemptBody(aBody), failBody(fBody), error(e), finallyBody(std::move(fiBody)), errorType(errorType) {}
+		AttemptStmt(std::vector<Stmt *> aBody, std::vector<Stmt *> fBody, Token e,
+								std::vector<Stmt *> fiBody, Token errorType) :
+				attemptBody(aBody), failBody(fBody), errorType(errorType), error(e), finallyBody(std::move(fiBody)) {}
 		void accept(StmtVisitor &visitor) override { visitor.visitAttemptStmt(*this); }
 	};
 	struct PanicStmt : public Stmt {
 		Token keyword;
-		std::shared_ptr<Expr> message; // The message to throw
+		Expr *message; // The message to throw
 
-		PanicStmt(Token keyword, std::shared_ptr<Expr> value) : keyword(keyword), message(std::move(value)) {}
+		PanicStmt(Token keyword, Expr *value) : keyword(keyword), message(value) {}
 
 		void accept(StmtVisitor &visitor) override { visitor.visitPanicStmt(*this); }
 	};
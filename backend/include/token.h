@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 #include "value.h"
@@ -90,16 +91,16 @@ namespace Backend {
 
 	struct Token {
 		TokenType type;
-		std::string lexeme;
-		RyValue literal;
+		std::string_view lexeme; // Points into the source, which must outlive the token, or into the AstArena
+		RyValue literal; // Numbers only, a string's text is its lexeme
 		int line;
 		int column;
-		Token(TokenType t, std::string lex, RyValue lit, int l, int c) :
-				type(t), lexeme(std::move(lex)), literal(std::move(lit)), line(l), column(c) {}
+		Token(TokenType t, std::string_view lex, RyValue lit, int l, int c) :
+				type(t), lexeme(lex), literal(lit), line(l), column(c) {}
 		Token() : type(TokenType::Nothing_Here), lexeme(""), literal(RyValue()), line(0), column(0) {}
 	};
 
-	inline static const std::unordered_map<std::string, TokenType> keywords{
+	inline static const std::unordered_map<std::string_view, TokenType> keywords{
 			{"import", TokenType::IMPORT},	 {"func", TokenType::FUNC},				{"while", TokenType::WHILE},
 			{"if", TokenType::IF},					 {"else", TokenType::ELSE},				{"true", TokenType::TRUE},
 			{"false", TokenType::FALSE},		 {"null", TokenType::NULL_TOKEN}, {"for", TokenType::FOR},
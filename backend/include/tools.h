@@ -36,6 +36,9 @@ namespace RyTools {
 				std::cerr << RyColor::CYAN << "    | " << RyColor::RESET << std::string(col - 1, ' ') << RyColor::RED << "^~~"
 									<< RyColor::RESET << std::endl;
 			}
+		} else if (showCaret && line > 0) {
+			// Bundles are run without their sources, the line number is all there is
+			std::cerr << "  " << RyColor::CYAN << "line " << line << RyColor::RESET << std::endl;
 		}
 		hadError = true;
 	}
@@ -16,15 +16,15 @@ RyValue Environment::get(const std::string &name, const Token &errorToken) {
 }
 
 void Environment::assign(Token name, RyVariable value) {
-	if (values.find(name.lexeme) != values.end()) {
-		values[name.lexeme] = std::move(value);
+	if (auto found = values.find(std::string(name.lexeme)); found != values.end()) {
+		found->second = std::move(value);
 		return;
 	}
 	if (auto parent = enclosing.lock()) {
 		parent->assign(name, value);
 		return;
 	}
-	throw RyRuntimeError(name, "Undefined variable '" + name.lexeme + "'.");
+	throw RyRuntimeError(name, "Undefined variable '" + std::string(name.lexeme) + "'.");
 }
 
 bool Environment::has(const std::string &name, const Token &errorToken) {
@@ -36,8 +36,8 @@ bool Environment::has(const std::string &name, const Token &errorToken) {
 }
 
 RyVariable &Environment::getVariable(Token name) {
-	if (values.find(name.lexeme) != values.end()) {
-		return values[name.lexeme];
+	if (auto found = values.find(std::string(name.lexeme)); found != values.end()) {
+		return found->second;
 	}
 	if (auto parent = enclosing.lock()) {
 		return parent->getVariable(name);
@@ -8,7 +8,6 @@
 
 using namespace Backend;
 
-std::vector<Token> Lexer::getTokens() const { return tokens; }
 char Lexer::peek() const {
 	if (isAtEnd())
 		return '\0';
@@ -44,8 +43,7 @@ bool Lexer::match(const char expected) {
 void Lexer::addToken(const Backend::TokenType type) { addToken(type, RyValue()); }
 
 void Lexer::addToken(TokenType type, RyValue literal) {
-	const std::string text = source.substr(start, current - start);
-	tokens.emplace_back(type, text, std::move(literal), line, static_cast<int>(tokenStartColumn));
+	pending.emplace_back(type, source.substr(start, current - start), literal, line, static_cast<int>(tokenStartColumn));
 }
 
 void Lexer::scanToken() {
@@ -157,20 +155,32 @@ void Lexer::scanToken() {
 				identifier();
 			} else {
 				const std::string s(1, c);
-				RyTools::report(line, static_cast<int>(tokenStartColumn), "", "Unexpected character: '" + s + "'", source);
+				RyTools::report(line, static_cast<int>(tokenStartColumn), "", "Unexpected character: '" + s + "'",
+												std::string(source));
 			}
 			break;
 	}
 }
 
-std::vector<Token> Lexer::scanTokens() {
-	while (!isAtEnd()) {
+Token Lexer::nextToken() {
+	while (pending.empty()) {
+		if (isAtEnd())
+			return Token(TokenType::EOF_TOKEN, "", RyValue(), line, static_cast<int>(tokenStartColumn));
 		tokenStartColumn = column;
 		start = current;
-		scanToken();
+		scanToken(); // Whitespace and comments add nothing
 	}
 
-	addToken(TokenType::EOF_TOKEN);
+	Token token = pending.front();
+	pending.pop_front();
+	return token;
+}
+
+std::vector<Token> Lexer::scanTokens() {
+	std::vector<Token> tokens;
+	do {
+		tokens.push_back(nextToken());
+	} while (tokens.back().type != TokenType::EOF_TOKEN);
 	return tokens;
 }
 
@@ -183,16 +193,13 @@ void Lexer::number() {
 		while (std::isdigit(peek()))
 			next();
 	}
-	const std::string text = source.substr(start, current - start);
-	addToken(TokenType::NUMBER, std::stod(text));
+	addToken(TokenType::NUMBER, std::stod(std::string(source.substr(start, current - start))));
 }
 void Lexer::identifier() {
 	while (std::isalnum(peek()) || peek() == '_')
 		next();
 
-	const std::string text = source.substr(start, current - start);
-
-	if (const auto it = keywords.find(text); it != keywords.end()) {
+	if (const auto it = keywords.find(source.substr(start, current - start)); it != keywords.end()) {
 		addToken(it->second);
 	} else {
 		addToken(TokenType::IDENTIFIER);
@@ -200,13 +207,23 @@ void Lexer::identifier() {
 }
 
 void Lexer::str() {
+	// A segment without escapes is a view of the source, value is only filled once one shows up
+	size_t segmentStart = current;
+	bool escaped = false;
 	std::string value;
+	auto segment = [&]() -> std::string_view {
+		return escaped ? arena.keep(value) : source.substr(segmentStart, current - segmentStart);
+	};
 
 	while (peek() != '"' && !isAtEnd()) {
 		if (peek() == '\\') {
+			if (!escaped) {
+				value.assign(source.substr(segmentStart, current - segmentStart));
+				escaped = true;
+			}
 			next(); // consume '\'
 			if (isAtEnd()) {
-				RyTools::report(line, column, "", "Unterminated string.", source);
+				RyTools::report(line, column, "", "Unterminated string.", std::string(source));
 				return;
 			}
 			char escapedChar = next();
@@ -236,43 +253,47 @@ void Lexer::str() {
 			}
 		} else if (peek() == '$' && peekNext() == '{') {
 			// Interpolation found. Add the segment we have so far.
-			if (!value.empty()) {
-				tokens.emplace_back(TokenType::STRING, value, value, line, static_cast<int>(tokenStartColumn));
-				tokens.emplace_back(TokenType::PLUS, "+", RyValue(), line, column);
+			if (current > segmentStart) {
+				pending.emplace_back(TokenType::STRING, segment(), RyValue(), line, static_cast<int>(tokenStartColumn));
+				pending.emplace_back(TokenType::PLUS, "+", RyValue(), line, column);
 			}
 
 			// Handle the interpolated variable
 			next();
 			next(); // consume ${
-			int varStart = current;
+			size_t varStart = current;
 			while (peek() != '}' && !isAtEnd())
 				next();
 			if (isAtEnd()) {
-				RyTools::report(line, column, "", "Unterminated interpolation.", source);
+				RyTools::report(line, column, "", "Unterminated interpolation.", std::string(source));
 				return;
 			}
-			std::string varName = source.substr(varStart, current - varStart);
-			tokens.emplace_back(TokenType::IDENTIFIER, varName, RyValue(), line, column);
+			pending.emplace_back(TokenType::IDENTIFIER, source.substr(varStart, current - varStart), RyValue(), line, column);
 			next(); // consume }
 
-			tokens.emplace_back(TokenType::PLUS, "+", RyValue(), line, column);
+			pending.emplace_back(TokenType::PLUS, "+", RyValue(), line, column);
 
 			// Reset for the next segment
+			segmentStart = current;
+			escaped = false;
 			value.clear();
 			tokenStartColumn = column;
 		} else {
 			if (peek() == '\n')
 				line++;
-			value += next();
+			char c = next();
+			if (escaped)
+				value += c;
 		}
 	}
 
 	if (isAtEnd()) {
-		RyTools::report(line, column, "", "Unterminated string.", source);
+		RyTools::report(line, column, "", "Unterminated string.", std::string(source));
 		return;
 	}
 
+	std::string_view text = segment();
 	next(); // consume closing "
 
-	tokens.emplace_back(TokenType::STRING, value, value, line, static_cast<int>(tokenStartColumn));
+	pending.emplace_back(TokenType::STRING, text, RyValue(), line, static_cast<int>(tokenStartColumn));
 }
@@ -15,10 +15,10 @@
 
 using namespace Backend;
 
-std::set<std::string> Parser::namespaces;
+std::set<std::string, std::less<>> Parser::namespaces;
 
-std::vector<std::shared_ptr<Stmt>> Parser::parse() {
-	std::vector<std::shared_ptr<Stmt>> statements;
+std::vector<Stmt *> Parser::parse() {
+	std::vector<Stmt *> statements;
 
 	try {
 		while (!isAtEnd()) {
@@ -36,17 +36,27 @@ std::vector<std::shared_ptr<Stmt>> Parser::parse() {
 	return statements;
 }
 
-Token Parser::peek() { return tokens[current]; }
+const Token &Parser::tokenAt(int index) {
+	while (pulled <= index) {
+		if (pulled > 0 && tokens[(pulled - 1) % WINDOW].type == TokenType::EOF_TOKEN)
+			return tokens[(pulled - 1) % WINDOW];
+		tokens[pulled % WINDOW] = lexer.nextToken();
+		pulled++;
+	}
+	return tokens[index % WINDOW];
+}
+
+const Token &Parser::peek() { return tokenAt(current); }
 
-Token Parser::next() {
+const Token &Parser::next() {
 	if (!isAtEnd())
 		current++;
 	return previous();
 }
 
-Token Parser::previous() { return tokens[current - 1]; }
+const Token &Parser::previous() { return tokenAt(current > 0 ? current - 1 : 0); }
 
-bool Parser::isAtEnd() const { return tokens[current].type == TokenType::EOF_TOKEN; }
+bool Parser::isAtEnd() { return tokenAt(current).type == TokenType::EOF_TOKEN; }
 
 bool Parser::match(const std::initializer_list<TokenType> types) {
 	for (const TokenType type: types) {
@@ -57,11 +67,11 @@ bool Parser::match(const std::initializer_list<TokenType> types) {
 	}
 	return false;
 }
-bool Parser::isTypeAlias(const std::string &name) { return externalTypeAliases.count(name) > 0; }
+bool Parser::isTypeAlias(std::string_view name) { return externalTypeAliases.count(name) > 0; }
 
-bool Parser::isTypeAlias(std::shared_ptr<Expr> expr) {
+bool Parser::isTypeAlias(Expr *expr) {
 	// Check if the expression is actually a VariableExpr
-	auto var = dynamic_cast<VariableExpr *>(expr.get());
+	auto var = dynamic_cast<VariableExpr *>(expr);
 	return var != nullptr;
 }
 bool Parser::check(const TokenType type) {
@@ -70,89 +80,89 @@ bool Parser::check(const TokenType type) {
 	return peek().type == type;
 }
 
-bool Parser::checkNext(const TokenType type) const {
+bool Parser::checkNext(const TokenType type) {
 	if (isAtEnd())
 		return false;
-	if (tokens[current + 1].type == TokenType::EOF_TOKEN)
+	if (tokenAt(current + 1).type == TokenType::EOF_TOKEN)
 		return false;
-	return tokens[current + 1].type == type;
+	return tokenAt(current + 1).type == type;
 }
 
-Token Parser::consume(const TokenType type, const std::string &message) {
+const Token &Parser::consume(const TokenType type, const std::string &message) {
 	if (check(type))
 		return next();
 
 	error(peek(), message);
-	return tokens[current];
+	return tokenAt(current);
 }
 
-std::shared_ptr<Expr> Parser::equality() {
+Expr *Parser::equality() {
 	auto expr = comparison();
 
 	while (match({TokenType::BANG_EQUAL, TokenType::EQUAL_EQUAL})) {
 		Token op = previous();
 		auto right = comparison();
-		expr = std::make_shared<MathExpr>(std::move(expr), op, std::move(right));
+		expr = arena.make<MathExpr>(std::move(expr), op, std::move(right));
 	}
 
 	return expr;
 }
 
-std::shared_ptr<Expr> Parser::logicalAnd() {
+Expr *Parser::logicalAnd() {
 	auto expr = equality();
 	while (match({TokenType::AND})) {
 		Token op = previous();
 		auto right = equality();
-		expr = std::make_shared<LogicalExpr>(std::move(expr), op, std::move(right));
+		expr = arena.make<LogicalExpr>(std::move(expr), op, std::move(right));
 	}
 	return expr;
 }
 
-std::shared_ptr<Expr> Parser::logicalOr() {
+Expr *Parser::logicalOr() {
 	auto expr = logicalAnd();
 	while (match({TokenType::OR})) {
 		Token op = previous();
 		auto right = logicalAnd();
-		expr = std::make_shared<LogicalExpr>(std::move(expr), op, std::move(right));
+		expr = arena.make<LogicalExpr>(std::move(expr), op, std::move(right));
 	}
 	return expr;
 }
 
-std::shared_ptr<Expr> Parser::comparison() {
+Expr *Parser::comparison() {
 	auto expr = bitwiseOr();
 
 	while (match({TokenType::GREATER, TokenType::GREATER_EQUAL, TokenType::LESS, TokenType::LESS_EQUAL})) {
 		Token op = previous();
 		auto right = bitwiseOr();
-		expr = std::make_shared<MathExpr>(std::move(expr), op, std::move(right));
+		expr = arena.make<MathExpr>(std::move(expr), op, std::move(right));
 	}
 	return expr;
 }
 
-std::shared_ptr<Expr> Parser::shift() {
+Expr *Parser::shift() {
 	auto expr = addition();
 
 	while (match({TokenType::LESS_LESS, TokenType::GREATER_GREATER})) {
 		Token op = previous();
 		auto right = addition();
-		expr = std::make_shared<ShiftExpr>(std::move(expr), op, std::move(right));
+		expr = arena.make<ShiftExpr>(std::move(expr), op, std::move(right));
 	}
 	return expr;
 }
 
 
-std::shared_ptr<Expr> Parser::range() {
+Expr *Parser::range() {
 	auto expr = shift();
 
 	while (match({TokenType::TO})) {
 		Token op = previous();
 		auto right = shift();
-		expr = std::make_shared<RangeExpr>(std::move(expr), op, std::move(right));
+		expr = arena.make<RangeExpr>(std::move(expr), op, std::move(right));
 	}
 	return expr;
 }
 
-std::shared_ptr<Expr> Parser::multiplication() {
+Expr *Parser::multiplication() {
 	auto expr = prefixed();
 
 	while (match({TokenType::STAR, TokenType::DIVIDE, TokenType::PERCENT})) {
@@ -160,42 +170,42 @@ std::shared_ptr<Expr> Parser::multiplication() {
 		auto right = prefixed();
 
 		// Wrap into our MathExpr struct
-		expr = std::make_shared<MathExpr>(std::move(expr), op, std::move(right));
+		expr = arena.make<MathExpr>(std::move(expr), op, std::move(right));
 	}
 
 	return expr;
 }
 
-std::shared_ptr<Expr> Parser::bitwiseOr() {
+Expr *Parser::bitwiseOr() {
 	auto expr = bitwiseXor();
 
 	while (match({TokenType::PIPE})) {
 		Token op = previous();
 		auto right = bitwiseXor();
-		expr = std::make_shared<BitwiseOrExpr>(std::move(expr), op, std::move(right));
+		expr = arena.make<BitwiseOrExpr>(std::move(expr), op, std::move(right));
 	}
 	return expr;
 }
 
-std::shared_ptr<Expr> Parser::bitwiseXor() {
+Expr *Parser::bitwiseXor() {
 	auto expr = bitwiseAnd();
 
 	while (match({TokenType::CARET})) {
 		Token op = previous();
 		auto right = bitwiseAnd();
-		expr = std::make_shared<BitwiseXorExpr>(std::move(expr), op, std::move(right));
+		expr = arena.make<BitwiseXorExpr>(std::move(expr), op, std::move(right));
 	}
 	return expr;
 }
 
 
-std::shared_ptr<Expr> Parser::bitwiseAnd() {
+Expr *Parser::bitwiseAnd() {
 	auto expr = range();
 
 	while (match({TokenType::AMPERSAND})) {
 		Token op = previous();
 		auto right = range();
-		expr = std::make_shared<BitwiseAndExpr>(std::move(expr), op, std::move(right));
+		expr = arena.make<BitwiseAndExpr>(std::move(expr), op, std::move(right));
 	}
 	return expr;
 }
@@ -204,15 +214,15 @@ void Parser::error(const Token &token, const std::string &message) {
 	RyTools::report(token.line, token.column, "", message, sourceCode);
 	throw RyTools::ParseError();
 }
-std::shared_ptr<Expr> Parser::expression() {
+Expr *Parser::expression() {
 	auto expr = assignment();
 
 	// Ry's Precalculator
-	Optimizer opt;
+	Optimizer opt(arena);
 	return opt.fold(expr);
 }
 
-std::shared_ptr<Expr> Parser::assignment() {
+Expr *Parser::assignment() {
 	auto expr = logicalOr();
 
 	if (match({TokenType::EQUAL})) {
@@ -220,13 +230,13 @@ std::shared_ptr<Expr> Parser::assignment() {
 		auto value = assignment();
 
 		// Check left side
-		if (auto var = dynamic_cast<VariableExpr *>(expr.get())) {
+		if (auto var = dynamic_cast<VariableExpr *>(expr)) {
 			Token name = var->name;
-			return std::make_shared<AssignExpr>(name, std::move(value));
-		} else if (auto get = dynamic_cast<GetExpr *>(expr.get())) {
-			return std::make_shared<SetExpr>(get->object, get->name, std::move(value));
-		} else if (auto index = dynamic_cast<IndexExpr *>(expr.get())) {
-			return std::make_shared<IndexSetExpr>(index->object, index->bracket, index->index, value);
+			return arena.make<AssignExpr>(name, std::move(value));
+		} else if (auto get = dynamic_cast<GetExpr *>(expr)) {
+			return arena.make<SetExpr>(get->object, get->name, std::move(value));
+		} else if (auto index = dynamic_cast<IndexExpr *>(expr)) {
+			return arena.make<IndexSetExpr>(index->object, index->bracket, index->index, value);
 		}
 
 
@@ -236,36 +246,36 @@ std::shared_ptr<Expr> Parser::assignment() {
 	return expr;
 }
 
-std::shared_ptr<Expr> Parser::addition() {
+Expr *Parser::addition() {
 	auto expr = multiplication();
 
 	while (match({TokenType::PLUS, TokenType::MINUS})) {
 		Token op = previous();
 		auto right = multiplication();
-		expr = std::make_shared<MathExpr>(std::move(expr), op, std::move(right));
+		expr = arena.make<MathExpr>(std::move(expr), op, std::move(right));
 	}
 
 	return expr;
 }
 
-std::shared_ptr<Expr> Parser::baseValue() {
+Expr *Parser::baseValue() {
 	// Handle Literals (Data)
 	if (match({TokenType::NUMBER, TokenType::STRING})) {
-		return std::make_shared<ValueExpr>(previous());
+		return arena.make<ValueExpr>(previous());
 	}
 
 	// Handle Identifiers
 	if (match({TokenType::IDENTIFIER})) {
-		return std::make_shared<VariableExpr>(previous());
+		return arena.make<VariableExpr>(previous());
 	}
 
 	// Handle Booleans
 	if (match({TokenType::TRUE, TokenType::FALSE, TokenType::NULL_TOKEN})) {
-		return std::make_shared<ValueExpr>(previous());
+		return arena.make<ValueExpr>(previous());
 	}
 
 	if (match({TokenType::LBRACKET})) {
-		std::vector<std::shared_ptr<Expr>> elements;
+		std::vector<Expr *> elements;
 		if (!check(TokenType::RBRACKET)) {
 			do {
 				// Recursion: lists can contain any expression (even other lists!)
@@ -273,20 +283,20 @@ std::shared_ptr<Expr> Parser::baseValue() {
 			} while (match({TokenType::COMMA}));
 		}
 		consume(TokenType::RBRACKET, "Expected ']' after list elements.");
-		return std::make_shared<ListExpr>(std::move(elements));
+		return arena.make<ListExpr>(std::move(elements));
 	}
 
 	// Handle Grouping (Parentheses)
 	if (match({TokenType::LPAREN})) {
 		auto expr = expression(); // Jump back to the top of the ladder
 		consume(TokenType::RPAREN, "Expected ')' after expression.");
-		return std::make_shared<GroupExpr>(std::move(expr));
+		return arena.make<GroupExpr>(std::move(expr));
 	}
 
 	// Handle '{'
 	if (match({TokenType::LBRACE})) {
 		// A vector to hold pairs of expressions
-		std::vector<std::pair<std::shared_ptr<Expr>, std::shared_ptr<Expr>>> items;
+		std::vector<std::pair<Expr *, Expr *>> items;
 
 		if (!check(TokenType::RBRACE)) {
 			do {
@@ -298,11 +308,11 @@ std::shared_ptr<Expr> Parser::baseValue() {
 		}
 
 		Token brace = consume(TokenType::RBRACE, "Expected '}' after map elements.");
-		return std::make_shared<MapExpr>(brace, std::move(items));
+		return arena.make<MapExpr>(brace, std::move(items));
 	}
 
 	if (match({TokenType::THIS})) {
-		return std::make_shared<ThisExpr>(previous());
+		return arena.make<ThisExpr>(previous());
 	}
 
 	// Fallback: Report the error instead of crashing
@@ -312,18 +322,18 @@ std::shared_ptr<Expr> Parser::baseValue() {
 	return nullptr;
 }
 
-std::shared_ptr<Expr> Parser::prefixed() {
+Expr *Parser::prefixed() {
 	if (match({TokenType::BANG, TokenType::MINUS, TokenType::TILDE, TokenType::PLUS_PLUS, TokenType::MINUS_MINUS})) {
 		Token op = previous();
 		// We call prefixed() recursively to handle multiple prefixes like "!!true"
 		auto right = prefixed();
-		return std::make_shared<PrefixExpr>(op, std::move(right));
+		return arena.make<PrefixExpr>(op, std::move(right));
 	}
 
 	return postfixed();
 }
 
-std::shared_ptr<Expr> Parser::postfixed() {
+Expr *Parser::postfixed() {
 	auto expr = baseValue();
 
 	while (true) {
@@ -332,27 +342,27 @@ std::shared_ptr<Expr> Parser::postfixed() {
 		} else if (match({TokenType::LBRACKET})) {
 			auto index = expression();
 			Token bracket = consume(TokenType::RBRACKET, "Expect ']' after index.");
-			expr = std::make_shared<IndexExpr>(std::move(expr), std::move(index), bracket);
+			expr = arena.make<IndexExpr>(std::move(expr), std::move(index), bracket);
 		} else if (match({TokenType::DOT})) {
 			Token name = consume(TokenType::IDENTIFIER, "Expect property name after '.'.");
 
-			if (auto var = std::dynamic_pointer_cast<VariableExpr>(expr)) {
+			if (auto var = dynamic_cast<VariableExpr *>(expr)) {
 				if (namespaces.count(var->name.lexeme) > 0) {
-					std::string mangledName = var->name.lexeme + "::" + name.lexeme;
+					std::string mangledName = std::string(var->name.lexeme) + "::" + std::string(name.lexeme);
 					Token mangledToken = var->name;
-					mangledToken.lexeme = mangledName;
+					mangledToken.lexeme = arena.keep(mangledName);
 					mangledToken.line = var->name.line;
 					mangledToken.column = var->name.column;
-					expr = std::make_shared<VariableExpr>(mangledToken);
+					expr = arena.make<VariableExpr>(mangledToken);
 				} else {
-					expr = std::make_shared<GetExpr>(expr, name);
+					expr = arena.make<GetExpr>(expr, name);
 				}
 			} else {
-				expr = std::make_shared<GetExpr>(expr, name);
+				expr = arena.make<GetExpr>(expr, name);
 			}
 		} else if (match({TokenType::PLUS_PLUS, TokenType::MINUS_MINUS})) {
 			Token op = previous();
-			expr = std::make_shared<PostfixExpr>(op, std::move(expr));
+			expr = arena.make<PostfixExpr>(op, std::move(expr));
 		} else {
 			break;
 		}
@@ -361,8 +371,8 @@ std::shared_ptr<Expr> Parser::postfixed() {
 	return expr;
 }
 
-std::shared_ptr<Expr> Parser::finishCall(std::shared_ptr<Expr> callee) {
-	std::vector<std::shared_ptr<Expr>> arguments;
+Expr *Parser::finishCall(Expr *callee) {
+	std::vector<Expr *> arguments;
 
 	if (!check(TokenType::RPAREN)) {
 		do {
@@ -372,10 +382,10 @@ std::shared_ptr<Expr> Parser::finishCall(std::shared_ptr<Expr> callee) {
 
 	Token paren = consume(TokenType::RPAREN, "Expect ')' after arguments.");
 
-	return std::make_shared<CallExpr>(std::move(callee), std::move(arguments), paren);
+	return arena.make<CallExpr>(std::move(callee), std::move(arguments), paren);
 }
 
-std::shared_ptr<Stmt> Parser::statement() {
+Stmt *Parser::statement() {
 	if (match({TokenType::DO}))
 		return untilStatement();
 	if (match({TokenType::WHILE}))
@@ -392,18 +402,18 @@ std::shared_ptr<Stmt> Parser::statement() {
 		if (loopDepth == 0) {
 			error(previous(), "Cannot use 'stop' outside of a loop.");
 		}
-		return std::make_shared<StopStmt>(previous());
+		return arena.make<StopStmt>(previous());
 	}
 	if (match({TokenType::SKIP})) {
 		if (loopDepth == 0) {
 			error(previous(), "Cannot use 'skip' outside of a loop.");
 		}
-		return std::make_shared<SkipStmt>(previous());
+		return arena.make<SkipStmt>(previous());
 	}
 	if (match({TokenType::UNLESS}))
 		return unlessStatement();
 	if (match({TokenType::LBRACE}))
-		return std::make_shared<BlockStmt>(block());
+		return arena.make<BlockStmt>(block());
 	if (match({TokenType::EACH}))
 		return eachStatement();
 	if (match({TokenType::CLASS}))
@@ -416,7 +426,7 @@ std::shared_ptr<Stmt> Parser::statement() {
 }
 
 
-std::shared_ptr<Stmt> Parser::declaration() {
+Stmt *Parser::declaration() {
 	if (match({TokenType::IMPORT}))
 		return ImportDeclaration();
 	if (match({TokenType::FUNC}))
@@ -426,7 +436,7 @@ std::shared_ptr<Stmt> Parser::declaration() {
 
 	// Check for the alias before anything else
 	if (check(TokenType::IDENTIFIER) && checkNext(TokenType::DOT)) {
-		if (tokens[current + 2].type == TokenType::IDENTIFIER && tokens[current + 3].type == TokenType::IDENTIFIER) {
+		if (tokenAt(current + 2).type == TokenType::IDENTIFIER && tokenAt(current + 3).type == TokenType::IDENTIFIER) {
 			Token namespaceToken = next(); // 'Math'
 			next(); // '.'
 
@@ -444,10 +454,10 @@ std::shared_ptr<Stmt> Parser::declaration() {
 	return statement();
 }
 
-std::shared_ptr<FunctionStmt> Parser::functionDeclaration(const std::string &kind) {
+FunctionStmt *Parser::functionDeclaration(const std::string &kind) {
 	Token name = consume(TokenType::IDENTIFIER, "Expect " + kind + " name.");
 	if (!currentNamespace.empty()) {
-		name.lexeme = currentNamespace + "::" + name.lexeme;
+		name.lexeme = arena.keep(currentNamespace + "::" + std::string(name.lexeme));
 	}
 	consume(TokenType::LPAREN, "Expect '(' before parameters");
 
@@ -471,7 +481,7 @@ std::shared_ptr<FunctionStmt> Parser::functionDeclaration(const std::string &kin
 
 			// The actual variable name
 			Token paramName = consume(TokenType::IDENTIFIER, "Expect parameter name.");
-			std::shared_ptr<Expr> defaultVal = nullptr;
+			Expr *defaultVal = nullptr;
 
 			// Default values (Optional)
 			if (match({TokenType::EQUAL})) {
@@ -497,20 +507,20 @@ std::shared_ptr<FunctionStmt> Parser::functionDeclaration(const std::string &kin
 	consume(TokenType::LBRACE, "Expect '{' before " + kind + " body.");
 
 	// Use std::move for the body to ensure the vector is passed correctly
-	std::vector<std::shared_ptr<Stmt>> body = block();
+	std::vector<Stmt *> body = block();
 
-	return std::make_shared<FunctionStmt>(name, parameters, std::move(body), std::move(returnTypeNamespace),
+	return arena.make<FunctionStmt>(name, parameters, std::move(body), std::move(returnTypeNamespace),
 																				std::move(returnTypeAlias));
 }
 
-std::shared_ptr<Stmt> Parser::ImportDeclaration() {
+Stmt *Parser::ImportDeclaration() {
 	consume(TokenType::LPAREN, "Expect '(' after import.");
-	std::shared_ptr<Expr> module = expression();
+	Expr *module = expression();
 	consume(TokenType::RPAREN, "Expect ')' after import.");
-	return std::make_shared<ImportStmt>(module);
+	return arena.make<ImportStmt>(module);
 }
 
-std::shared_ptr<Stmt> Parser::whileStatement() {
+Stmt *Parser::whileStatement() {
 	loopDepth++;
 	if (check(TokenType::LBRACE)) {
 		error(previous(), "Expect condition before '{'.");
@@ -519,13 +529,13 @@ std::shared_ptr<Stmt> Parser::whileStatement() {
 
 	auto body = statement();
 	loopDepth--;
-	return std::make_shared<WhileStmt>(std::move(condition), body);
+	return arena.make<WhileStmt>(std::move(condition), body);
 }
 
-std::shared_ptr<Stmt> Parser::forStatement() {
+Stmt *Parser::forStatement() {
 	loopDepth++;
 
-	std::shared_ptr<Stmt> initializer = nullptr;
+	Stmt *initializer = nullptr;
 	if (check(TokenType::LBRACE)) {
 		error(previous(), "Expect condition before '{'.");
 	}
@@ -537,24 +547,24 @@ std::shared_ptr<Stmt> Parser::forStatement() {
 
 	consume(TokenType::COMMA, "Expect ',' after loop initializer.");
 
-	std::shared_ptr<Expr> condition = nullptr;
+	Expr *condition = nullptr;
 	if (!check(TokenType::COMMA)) {
 		condition = expression();
 	}
 	consume(TokenType::COMMA, "Expect ',' after loop condition.");
 
-	std::shared_ptr<Expr> increment = nullptr;
+	Expr *increment = nullptr;
 	if (!check(TokenType::RBRACE)) {
 		increment = expression();
 	}
 
-	std::shared_ptr<Stmt> body = statement();
+	Stmt *body = statement();
 
 	loopDepth--;
-	return std::make_shared<ForStmt>(std::move(initializer), std::move(condition), std::move(increment), body);
+	return arena.make<ForStmt>(std::move(initializer), std::move(condition), std::move(increment), body);
 }
 
-std::shared_ptr<Stmt> Parser::eachStatement() {
+Stmt *Parser::eachStatement() {
 	loopDepth++;
 	Token typeToken(TokenType::Nothing_Here, "", RyValue(), 0, 0); // Rename to avoid confusion
 
@@ -573,24 +583,24 @@ std::shared_ptr<Stmt> Parser::eachStatement() {
 	loopDepth--;
 
 	if (typeToken.type == TokenType::Nothing_Here) {
-		return std::make_shared<EachStmt>(name, iterable, body);
+		return arena.make<EachStmt>(name, iterable, body);
 	} else {
-		return std::make_shared<EachStmt>(name, iterable, body, typeToken);
+		return arena.make<EachStmt>(name, iterable, body, typeToken);
 	}
 }
 
-std::shared_ptr<Stmt> Parser::AliasDeclaration() {
-	std::shared_ptr<Expr> aliasExpr;
+Stmt *Parser::AliasDeclaration() {
+	Expr *aliasExpr;
 
 	// Check if we are aliasing a raw data type (data::num)
 	if (match({TokenType::DATA})) {
 		consume(TokenType::DOUBLE_COLON, "Expect '::' after data");
 		Token type = consume(TokenType::IDENTIFIER, "Expect type name");
-		aliasExpr = std::make_shared<VariableExpr>(type); // Wrap the type name
+		aliasExpr = arena.make<VariableExpr>(type); // Wrap the type name
 	}
 	// Check if we are aliasing an EXISTING type alias (num as integer)
 	else if (check(TokenType::IDENTIFIER) && isTypeAlias(peek().lexeme)) {
-		aliasExpr = std::make_shared<VariableExpr>(next());
+		aliasExpr = arena.make<VariableExpr>(next());
 	}
 	// Otherwise, it's a normal variable/function alias
 	else {
@@ -601,13 +611,13 @@ std::shared_ptr<Stmt> Parser::AliasDeclaration() {
 	Token name = consume(TokenType::IDENTIFIER, "Expect alias name.");
 
 	if (isTypeAlias(aliasExpr)) {
-		typeAliases.insert(name.lexeme);
+		typeAliases.emplace(name.lexeme);
 	}
 
-	return std::make_shared<AliasStmt>(aliasExpr, name);
+	return arena.make<AliasStmt>(aliasExpr, name);
 }
 
-std::shared_ptr<VarStmt> Parser::typeDeclaration(std::optional<Token> prefix, bool isPrivate) {
+VarStmt *Parser::typeDeclaration(std::optional<Token> prefix, bool isPrivate) {
 	Token typeToken = prefix.has_value() ? prefix.value() : previous();
 	if (prefix.has_value()) {
 		typeToken = prefix.value();
@@ -618,7 +628,7 @@ std::shared_ptr<VarStmt> Parser::typeDeclaration(std::optional<Token> prefix, bo
 	}
 
 
-	std::shared_ptr<Expr> initializer = nullptr;
+	Expr *initializer = nullptr;
 	std::optional<Token> innerTypeToken = std::nullopt;
 	Token name = Token(TokenType::Nothing_Here, "", RyValue(), 0, 0);
 
@@ -628,7 +638,7 @@ std::shared_ptr<VarStmt> Parser::typeDeclaration(std::optional<Token> prefix, bo
 
 	name = consume(TokenType::IDENTIFIER, "Expect variable name.");
 	if (!currentNamespace.empty()) {
-		name.lexeme = currentNamespace + "::" + name.lexeme;
+		name.lexeme = arena.keep(currentNamespace + "::" + std::string(name.lexeme));
 	}
 
 
@@ -637,22 +647,22 @@ std::shared_ptr<VarStmt> Parser::typeDeclaration(std::optional<Token> prefix, bo
 	}
 
 
-	return std::make_shared<VarStmt>(typeToken, innerTypeToken, name, initializer, isPrivate);
+	return arena.make<VarStmt>(typeToken, innerTypeToken, name, initializer, isPrivate);
 }
-std::shared_ptr<Stmt> Parser::expressionStatement() {
+Stmt *Parser::expressionStatement() {
 	auto expr = expression();
-	return std::make_shared<ExpressionStmt>(std::move(expr));
+	return arena.make<ExpressionStmt>(std::move(expr));
 }
 
-std::shared_ptr<Stmt> Parser::returnStatement() {
+Stmt *Parser::returnStatement() {
 	Token keyword = previous(); // This is the 'return' token
-	std::shared_ptr<Expr> value = nullptr;
+	Expr *value = nullptr;
 
 	value = expression();
-	return std::make_shared<ReturnStmt>(keyword, std::move(value));
+	return arena.make<ReturnStmt>(keyword, std::move(value));
 }
 
-std::shared_ptr<Stmt> Parser::ifStatement() {
+Stmt *Parser::ifStatement() {
 	if (check(TokenType::LBRACE)) {
 		error(previous(), "Expect condition before '{'.");
 	}
@@ -661,16 +671,16 @@ std::shared_ptr<Stmt> Parser::ifStatement() {
 		error(previous(), "Expect '{' after if condition.");
 	}
 	auto thenBranch = statement();
-	std::shared_ptr<Stmt> elseBranch = nullptr;
+	Stmt *elseBranch = nullptr;
 
 	if (match({TokenType::ELSE})) {
 		elseBranch = statement();
 	}
 
-	return std::make_shared<IfStmt>(std::move(condition), std::move(thenBranch), std::move(elseBranch));
+	return arena.make<IfStmt>(std::move(condition), std::move(thenBranch), std::move(elseBranch));
 }
 
-std::shared_ptr<Stmt> Parser::unlessStatement() {
+Stmt *Parser::unlessStatement() {
 	Token op = previous();
 	op.type = TokenType::BANG;
 	op.lexeme = "!";
@@ -679,23 +689,23 @@ std::shared_ptr<Stmt> Parser::unlessStatement() {
 		error(previous(), "Expect condition before '{'.");
 	}
 	auto condition = expression();
-	auto flippedCondition = std::make_shared<PrefixExpr>(op, std::move(condition));
+	auto flippedCondition = arena.make<PrefixExpr>(op, std::move(condition));
 
 	if (!check(TokenType::LBRACE)) {
 		error(previous(), "Expect '{' after unless condition.");
 	}
 
 	auto thenBranch = statement();
-	std::shared_ptr<Stmt> elseBranch = nullptr;
+	Stmt *elseBranch = nullptr;
 
 	if (match({TokenType::ELSE})) {
 		elseBranch = statement();
 	}
 
-	return std::make_shared<IfStmt>(std::move(flippedCondition), std::move(thenBranch), std::move(elseBranch));
+	return arena.make<IfStmt>(std::move(flippedCondition), std::move(thenBranch), std::move(elseBranch));
 }
 
-std::shared_ptr<Stmt> Parser::untilStatement() {
+Stmt *Parser::untilStatement() {
 	loopDepth++;
 
 	// Parse the body of the 'do' block
@@ -712,50 +722,50 @@ std::shared_ptr<Stmt> Parser::untilStatement() {
 		error(previous(), "Expect condition after 'until'.");
 	}
 	auto condition = expression();
-	auto flippedCondition = std::make_shared<PrefixExpr>(op, std::move(condition));
+	auto flippedCondition = arena.make<PrefixExpr>(op, std::move(condition));
 
 	loopDepth--;
 
 	// Create a while loop that uses the SAME body
-	auto whileLoop = std::make_shared<WhileStmt>(std::move(flippedCondition), body);
+	auto whileLoop = arena.make<WhileStmt>(std::move(flippedCondition), body);
 
 	// Wrap them in a list of statements
-	std::vector<std::shared_ptr<Stmt>> statements;
+	std::vector<Stmt *> statements;
 	statements.push_back(body); // Run once first
 	statements.push_back(whileLoop); // Then check the loop
 
 	// Return them as a single Block statement
-	return std::make_shared<BlockStmt>(std::move(statements));
+	return arena.make<BlockStmt>(std::move(statements));
 }
 
 
-std::shared_ptr<Stmt> Parser::namespaceStatement() {
+Stmt *Parser::namespaceStatement() {
 	Token name = consume(TokenType::IDENTIFIER, "Expect namespace name.");
 
 	std::string previousNamespace = currentNamespace;
-	currentNamespace = (currentNamespace.empty()) ? name.lexeme : currentNamespace + "::" + name.lexeme;
+	currentNamespace = (currentNamespace.empty()) ? std::string(name.lexeme) : currentNamespace + "::" + std::string(name.lexeme);
 
-	namespaces.insert(name.lexeme);
+	namespaces.emplace(name.lexeme);
 
 	consume(TokenType::LBRACE, "Expect '{' after namespace body.");
 
-	std::vector<std::shared_ptr<Stmt>> body = block();
+	std::vector<Stmt *> body = block();
 
 	currentNamespace = previousNamespace;
 
-	return std::make_shared<NamespaceStmt>(name, body);
+	return arena.make<NamespaceStmt>(name, body);
 }
 
-std::shared_ptr<Stmt> Parser::classStatement() {
-	std::vector<std::shared_ptr<FunctionStmt>> methods;
-	std::vector<std::shared_ptr<VarStmt>> fields;
+Stmt *Parser::classStatement() {
+	std::vector<FunctionStmt *> methods;
+	std::vector<VarStmt *> fields;
 	bool isPrivate = false;
-	std::shared_ptr<VariableExpr> superclass = nullptr;
+	VariableExpr *superclass = nullptr;
 
 	Token name = consume(TokenType::IDENTIFIER, "Expect class name.");
 	if (match({TokenType::CHILDOF})) {
 		consume(TokenType::IDENTIFIER, "Expect superclass name after 'childof'.");
-		superclass = std::make_shared<VariableExpr>(previous());
+		superclass = arena.make<VariableExpr>(previous());
 	}
 	consume(TokenType::LBRACE, "Expect '{' before class body.");
 
@@ -776,14 +786,14 @@ std::shared_ptr<Stmt> Parser::classStatement() {
 	}
 
 	consume(TokenType::RBRACE, "Expect '}' after class body.");
-	return std::make_shared<ClassStmt>(name, std::move(methods), std::move(fields), isPrivate, superclass);
+	return arena.make<ClassStmt>(name, std::move(methods), std::move(fields), isPrivate, superclass);
 }
 
-std::shared_ptr<Stmt> Parser::attemptStatement() {
-	std::vector<std::shared_ptr<Stmt>> attemptBody;
-	std::vector<std::shared_ptr<Stmt>> failBody;
+Stmt *Parser::attemptStatement() {
+	std::vector<Stmt *> attemptBody;
+	std::vector<Stmt *> failBody;
 	Token error = Token(TokenType::Nothing_Here, "", RyValue(), 0, 0);
-	std::vector<std::shared_ptr<Stmt>> finallyBody;
+	std::vector<Stmt *> finallyBody;
 	Token errorType = Token(TokenType::Nothing_Here, "", RyValue(), 0, 0);
 
 	consume(TokenType::LBRACE, "Expect '{' before attempt block.");
@@ -800,19 +810,19 @@ std::shared_ptr<Stmt> Parser::attemptStatement() {
 		consume(TokenType::LBRACE, "Expect '{' before finally block.");
 		finallyBody = block();
 	}
-	return std::make_shared<AttemptStmt>(std::move(attemptBody), std::move(failBody), error, finallyBody, errorType);
+	return arena.make<AttemptStmt>(std::move(attemptBody), std::move(failBody), error, finallyBody, errorType);
 }
 
-std::shared_ptr<Stmt> Parser::panicStatement() {
+Stmt *Parser::panicStatement() {
 	Token keyword = previous();
-	std::shared_ptr<Expr> value = nullptr;
+	Expr *value = nullptr;
 	if (!check(TokenType::RBRACE) && !isAtEnd())
 		value = expression();
-	return std::make_shared<PanicStmt>(keyword, value);
+	return arena.make<PanicStmt>(keyword, value);
 }
 
-std::vector<std::shared_ptr<Stmt>> Parser::block() {
-	std::vector<std::shared_ptr<Stmt>> statements;
+std::vector<Stmt *> Parser::block() {
+	std::vector<Stmt *> statements;
 	while (!check(TokenType::RBRACE) && !isAtEnd()) {
 		statements.push_back(declaration());
 	}
@@ -1,7 +1,9 @@
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <memory>
 #include <string>
+#include "bytecode.h"
 #include "chunk.h"
 #include "colors.h"
 #include "compiler.h"
@@ -18,37 +20,37 @@ namespace RyRuntime {
 	void setVMSource(const std::string &source);
 }
 
-void interpret(VM &vm, const std::string &source) {
-	// Reset flag to stop infinite loops
+// Lexes, parses and compiles source, nullptr after reporting an error
+Frontend::RyFunction *compileSource(const std::string &source, const std::string &name) {
 	RyTools::hadError = false;
 
-	RyRuntime::setVMSource(source);
+	Backend::AstArena arena; // Every node of the tree and lexeme not in the source, freed once the chunk is compiled
 
-	// Lexing
-	Backend::Lexer lexer(source);
-	std::vector<Backend::Token> tokens = lexer.scanTokens();
+	// Lexing, the parser pulls tokens as it needs them
+	Backend::Lexer lexer(source, arena);
 
 	// Setup Aliases & Parsing
-	std::set<std::string> aliases; // Temporary set for the parser
-	Backend::Parser parser(tokens, aliases, source);
+	std::set<std::string, std::less<>> aliases; // Temporary set for the parser
+	Backend::Parser parser(lexer, arena, aliases, source);
 
-	std::vector<std::shared_ptr<Backend::Stmt>> statements = parser.parse();
+	std::vector<Backend::Stmt *> statements = parser.parse();
 
 	if (RyTools::hadError)
 
-		return;
+		return nullptr;
 
 	//  Compiling
 	Compiler compiler = Compiler(nullptr, source);
 	Chunk chunk;
 	if (!compiler.compile(statements, &chunk)) {
 		std::cout << "Compilation failed.\n";
-		return;
+		return nullptr;
 	}
 
-	auto function = std::make_shared<Frontend::RyFunction>(std::move(chunk), "<main>", 0);
+	return allocateObject<Frontend::RyFunction>(std::move(chunk), name, 0);
+}
 
-	// Running
+void run(VM &vm, Frontend::RyFunction *function) {
 	vm.interpret(function);
 	std::fflush(stdout);
 	std::fflush(stderr);
@@ -56,6 +58,95 @@ void interpret(VM &vm, const std::string &source) {
 	std::cerr << std::flush;
 }
 
+// Runs source, reusing the bytecode cached at cachePath when it was compiled from the same source
+void interpret(VM &vm, const std::string &source, const std::string &cachePath = "") {
+	// Reset flag to stop infinite loops
+	RyTools::hadError = false;
+
+	RyRuntime::setVMSource(source);
+
+	uint64_t sourceHash = hashSource(source);
+	Frontend::RyFunction *function = cachePath.empty() ? nullptr : readBytecode(cachePath, sourceHash);
+
+	if (function == nullptr) {
+		function = compileSource(source, "<main>");
+		if (function == nullptr)
+			return;
+		if (!cachePath.empty())
+			writeBytecode(cachePath, function, sourceHash); // Best effort, an unwritable directory just means no cache
+	}
+
+	run(vm, function);
+}
+
+bool readFile(const std::string &path, std::string &contents) {
+	std::ifstream file(path);
+	if (!file.is_open()) {
+		std::cerr << "Could not open file: " << path << "\n";
+		return false;
+	}
+	contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	return true;
+}
+
+// ry compile: the script and every module it imports, transitively, in one bytecode file
+int compileBundle(const std::string &scriptPath, const std::string &outputPath) {
+	std::string source;
+	if (!readFile(scriptPath, source))
+		return 1;
+	RyRuntime::setVMSource(source);
+	Frontend::RyFunction *main = compileSource(source, "<main>");
+	if (main == nullptr)
+		return 1;
+
+	std::vector<BundledModule> modules;
+	std::set<std::string> seen;
+	std::vector<std::string> pending = importedPaths(main);
+	while (!pending.empty()) {
+		std::string path = pending.back();
+		pending.pop_back();
+		if (!seen.insert(path).second)
+			continue;
+
+		// Resolved the way VM::loadModule() resolves it, so run from where the script will be run
+		std::string fileName = RyTools::findModulePath(path, false);
+		std::string moduleSource;
+		if (fileName.empty() || !readFile(fileName, moduleSource)) {
+			std::cerr << "Could not find module '" << path << "'.\n";
+			return 1;
+		}
+		RyRuntime::setVMSource(moduleSource);
+		Frontend::RyFunction *module = compileSource(moduleSource, fileName);
+		if (module == nullptr)
+			return 1;
+		modules.push_back({path, module});
+		for (const std::string &imported: importedPaths(module))
+			pending.push_back(imported);
+	}
+
+	if (!writeBundle(outputPath, main, hashSource(source), modules)) {
+		std::cerr << "Could not write bytecode file: " << outputPath << "\n";
+		return 1;
+	}
+	return 0;
+}
+
+// ry run file.ryc: a bundle from ry compile, the sources are never read
+int runBundle(VM &vm, const std::string &path) {
+	std::vector<BundledModule> modules;
+	Frontend::RyFunction *main = readBundle(path, modules);
+	if (main == nullptr) {
+		std::cerr << "Could not load bytecode file: " << path << " (missing, damaged or built by another version)\n";
+		return 1;
+	}
+	for (const BundledModule &module: modules)
+		vm.addBundledModule(module.path, module.function);
+
+	RyRuntime::setVMSource("");
+	run(vm, main);
+	return 0;
+}
+
 void runREPL(VM &vm) {
 	std::string line;
 	std::string buffer;
@@ -113,14 +204,24 @@ int main(int argc, char *argv[]) {
 	if (argc >= 2) {
 		std::string command = argv[1];
 
-		if (command == "run" && argc == 3) {
-			std::ifstream inputFile(argv[2]);
-			if (!inputFile.is_open()) {
-				std::cerr << "Could not open file: " << argv[2] << "\n";
-				return 1;
+		if (command == "run" && (argc == 3 || (argc == 5 && std::string(argv[2]) == "--max-depth"))) {
+			std::string path = argv[argc - 1];
+			if (argc == 5) {
+				int depth = std::atoi(argv[3]);
+				if (depth <= 0) {
+					std::cerr << "--max-depth expects a positive number.\n";
+					return 1;
+				}
+				vm.setCallDepthLimit(depth);
 			}
-			std::string src((std::istreambuf_iterator<char>(inputFile)), std::istreambuf_iterator<char>());
-			interpret(vm, src);
+			if (path.size() > 4 && path.compare(path.size() - 4, 4, ".ryc") == 0)
+				return runBundle(vm, path);
+			std::string src;
+			if (!readFile(path, src))
+				return 1;
+			interpret(vm, src, bytecodePath(path));
+		} else if (command == "compile" && (argc == 3 || (argc == 5 && std::string(argv[3]) == "-o"))) {
+			return compileBundle(argv[2], argc == 5 ? argv[4] : bundlePath(argv[2]));
 		} else if (command == "-v" || command == "--version") {
 			std::cout << "Ry (ByteCode Edition) v0.2.0\n";
 		} else {
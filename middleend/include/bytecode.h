@@ -0,0 +1,58 @@
+#ifndef ry_bytecode_h
+#define ry_bytecode_h
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Frontend {
+	class RyFunction;
+}
+
+namespace RyRuntime {
+
+	/*
+	 * Compiled scripts cached on disk, so running or importing an unchanged script skips
+	 * the lexer, parser and compiler.
+	 * A cache file holds the function and every function nested in its constants. It is only
+	 * used when its format version and source hash match. Global slots and method symbols are
+	 * handed out per process, so the file keeps their names and they are interned again on load.
+	 * Quickened opcodes are written back in their generic form and inline caches start empty.
+	 * A bundle made by `ry compile` is the same file with every module the script imports
+	 * appended, so it runs without the sources.
+	 */
+
+	// A precompiled module, found by the path an import statement names
+	struct BundledModule {
+		std::string path;
+		Frontend::RyFunction *function;
+	};
+
+	// What a cache file is validated against
+	uint64_t hashSource(std::string_view source);
+
+	// Where the cache of a script lives: next to it, script.ry -> script.ryc
+	std::string bytecodePath(const std::string &scriptPath);
+
+	// Where `ry compile` puts a bundle without -o, script.ry -> script.bundle.ryc so a cache never replaces it
+	std::string bundlePath(const std::string &scriptPath);
+
+	// False if the function holds a constant that cannot be cached, the file cannot be written or path holds a bundle
+	bool writeBytecode(const std::string &path, Frontend::RyFunction *function, uint64_t sourceHash);
+
+	// False if a function holds a constant that cannot be cached or the file cannot be written
+	bool writeBundle(const std::string &path, Frontend::RyFunction *function, uint64_t sourceHash,
+									 const std::vector<BundledModule> &modules);
+
+	// nullptr if the file is missing, damaged, from another format version or built from other source
+	Frontend::RyFunction *readBytecode(const std::string &path, uint64_t sourceHash);
+
+	// Loads a bundle whatever source it came from, nullptr if it is missing, damaged or from another version
+	Frontend::RyFunction *readBundle(const std::string &path, std::vector<BundledModule> &modules);
+
+	// The paths a function imports by string literal, nested functions included
+	std::vector<std::string> importedPaths(Frontend::RyFunction *function);
+} // namespace RyRuntime
+
+#endif
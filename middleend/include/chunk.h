@@ -20,8 +20,8 @@ namespace RyRuntime {
 		OP_SET_GLOBAL,
 		OP_GET_LOCAL,
 		OP_SET_LOCAL,
-		OP_GET_PROPERTY,
-		OP_SET_PROPERTY,
+		OP_GET_PROPERTY, // name, 2-byte inline cache index
+		OP_SET_PROPERTY, // name, 2-byte inline cache index
 		OP_CLOSURE,
 		OP_GET_UPVALUE,
 		OP_SET_UPVALUE,
@@ -64,21 +64,89 @@ namespace RyRuntime {
 
 		// Ry Specifics
 		OP_CALL, // test()
+		OP_TAIL_CALL, // return test(): argCount, runs a closure in the caller's frame, anything else like OP_CALL
+		OP_INVOKE, // obj.name(): name, argCount, 2-byte inline cache index
 		OP_CLASS, // class
-		OP_METHOD,
+		OP_METHOD, // 2-byte method symbol
 		OP_INHERIT, // childof
 		OP_PANIC, // panic
 		OP_RETURN, // return
 		OP_FUNCTION, // func test() {}
 		OP_ATTEMPT, // attempt {} fail err {}
 		OP_END_ATTEMPT,
-		OP_IMPORT
+		OP_IMPORT,
+
+		// Register forms: OP dst, a, b where a is a local slot and b is a slot (RR) or a constant (RK)
+		OP_ADD_RR,
+		OP_ADD_RK,
+		OP_SUBTRACT_RR,
+		OP_SUBTRACT_RK,
+		OP_MULTIPLY_RR,
+		OP_MULTIPLY_RK,
+		OP_LESS_RR,
+		OP_LESS_RK,
+
+		// Superinstructions, only produced by the peephole pass
+		OP_INC_LOCAL, // slot: slots[slot] + 1
+		OP_ADD_LOCAL_CONST, // slot, K: slots[slot] + K
+		OP_JUMP_IF_NOT_LESS, // offset: pops a and b, jumps unless a < b
+		OP_JUMP_IF_NOT_LESS_LOCAL_CONST, // slot, K, offset
+		OP_JUMP_IF_NOT_LESS_LOCAL_LOCAL, // slot, slot, offset
+
+		// Quickened forms, the VM rewrites a generic opcode in place once it has seen its operand types
+		OP_ADD_NUM_NUM,
+		OP_ADD_STR_STR,
+		OP_LESS_NUM_NUM,
+
+		OP_COUNT // Number of opcodes, not an instruction
+	};
+
+	// A register form dst that pushes the result instead of storing it in a slot
+	static const uint8_t REG_PUSH = 0xff;
+
+	class Shape;
+
+	// The inline cache of one OP_GET_PROPERTY/OP_SET_PROPERTY site, filled in by the VM
+	struct PropertyCache {
+		static const int WAYS = 4; // Shapes remembered per site, past that the last entry keeps being replaced
+
+		struct Entry {
+			uint32_t shapeId = 0; // 0 never matches a shape
+			int slot = -1; // The field's slot, or -1 when a GET site found a method
+			RyClosure *method = nullptr; // GET: the method to bind when slot is -1
+			Shape *transition = nullptr; // SET: the shape once the field is added, when the site adds it
+		};
+
+		Entry entries[WAYS];
+		int count = 0;
+
+		const Entry *find(uint32_t shapeId) const {
+			for (int i = 0; i < count; i++) {
+				if (entries[i].shapeId == shapeId)
+					return &entries[i];
+			}
+			return nullptr;
+		}
+
+		// A shape already cached has its entry replaced, so each shape holds one way
+		const Entry *add(const Entry &entry) {
+			for (int i = 0; i < count; i++) {
+				if (entries[i].shapeId == entry.shapeId) {
+					entries[i] = entry;
+					return &entries[i];
+				}
+			}
+			Entry &target = entries[count < WAYS ? count++ : WAYS - 1];
+			target = entry;
+			return &target;
+		}
 	};
 
 	// The sequence of bytecode
 	struct Chunk {
 		std::vector<uint8_t> code; // The Instructions
 		std::vector<RyValue> constants; // For numbers/strings
+		std::vector<PropertyCache> propertyCaches; // Indexed by the 2-byte operand of the property opcodes
 
 		// For error reporting
 		std::vector<int> lines;
@@ -96,6 +164,9 @@ namespace RyRuntime {
 			return constants.size() - 1;
 		}
 	};
+
+	// The size in bytes of the instruction at offset, operands included
+	int instructionLength(const Chunk &chunk, int offset);
 } // namespace RyRuntime
 
 #endif
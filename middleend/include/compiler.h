@@ -4,6 +4,7 @@
 #include <unordered_set>
 #include "chunk.h"
 #include "expr.h"
+#include "globals.h"
 #include "native.hpp"
 #include "stmt.h"
 #include "token.h"
@@ -43,13 +44,15 @@ namespace RyRuntime {
 			}
 		}
 		// Main entry point: takes source and returns a compiled chunk
-		bool compile(const std::vector<std::shared_ptr<Backend::Stmt>> &statements, Chunk *chunk);
+		bool compile(const std::vector<Backend::Stmt *> &statements, Chunk *chunk);
 
 	private:
 		// Error reporting
 		int currentLine;
 		int currentColumn;
+		bool failed = false; // An error was reported, set on every enclosing compiler too so compile() returns false
 		void error(const Backend::Token &token, const std::string &message);
+		void errorAtCurrent(const std::string &message); // At the last tracked token
 		std::string sourceCode;
 		void track(Backend::Token token);
 
@@ -98,6 +101,13 @@ namespace RyRuntime {
 		void emitBytes(uint8_t byte1, uint8_t byte2);
 		void emitConstant(RyValue value);
 		int makeConstant(RyValue value);
+		void emitGlobal(uint8_t instruction, std::string_view name); // Emits a global opcode with a 2-byte slot
+		// Emits a property opcode with its own inline cache, OP_INVOKE also takes argCount
+		void emitProperty(uint8_t instruction, std::string_view name, int argCount = 0);
+
+		// Register forms
+		int registerOperand(Backend::Expr *expr); // The local slot an operand lives in, or -1
+		bool emitRegisterBinary(uint8_t dst, Backend::MathExpr &expr); // False if the operands need the stack
 
 		// Jump helpers
 		int emitJump(uint8_t instruction);
@@ -106,9 +116,9 @@ namespace RyRuntime {
 
 		Chunk *compilingChunk;
 		std::shared_ptr<Frontend::ClassCompiler> currentClass = nullptr;
-		void compileStatement(std::shared_ptr<Backend::Stmt> stmt);
-		void compileExpression(std::shared_ptr<Backend::Expr> expr);
-		void compileMethod(std::shared_ptr<Backend::FunctionStmt> stmt);
+		void compileStatement(Backend::Stmt *stmt);
+		void compileExpression(Backend::Expr *expr);
+		void compileMethod(Backend::FunctionStmt *stmt);
 
 
 		// Scope & Locals
@@ -127,6 +137,10 @@ namespace RyRuntime {
 
 		// Stack helpers
 		std::vector<LoopContext> loopStack;
+
+		// Tail calls
+		bool tailCalls = false; // Only in function bodies, and never in init, whose return is replaced by 'this'
+		int attemptDepth = 0; // A panic inside an attempt body needs this frame to still be there
 	};
 } // namespace RyRuntime
 
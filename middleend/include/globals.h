@@ -0,0 +1,39 @@
+#ifndef ry_globals_h
+#define ry_globals_h
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace RyRuntime {
+
+	/*
+	 * Maps every name of one kind to a fixed slot.
+	 * The compiler interns names here and emits the slot as a 2-byte operand,
+	 * the VM keeps the values in a plain array indexed by the same slots.
+	 * Names are only read back for error messages and name-based lookups.
+	 */
+	class SymbolTable {
+	public:
+		static const int MAX_SLOTS = UINT16_MAX + 1; // Slots are encoded in 2 bytes
+
+		int slotFor(const std::string &name); // Returns the slot for a name, adding it if needed, -1 once the table is full
+		int find(const std::string &name) const; // Returns -1 if the name was never interned
+		const std::string &nameOf(int slot) const { return names[slot]; }
+		int size() const { return (int) names.size(); }
+
+	private:
+		std::vector<std::string> names; // Slot -> name
+		std::unordered_map<std::string, int> slots; // Name -> slot
+	};
+
+	// The global variables, shared by every compiler and the VM
+	SymbolTable &globalNames();
+
+	// The method names, a class's vtable is indexed by these
+	SymbolTable &methodNames();
+	static const int INIT_METHOD = 0; // The constructor is always interned first
+} // namespace RyRuntime
+
+#endif
@@ -1,12 +1,15 @@
 #pragma once
+#include "arena.h"
 #include "expr.h"
-#include <memory>
 
 namespace Backend {
     // Inherit publicly from ExprVisitor
+    // Folds in place: children are replaced where they fold and a node that does not fold is returned as is
     class Optimizer : public ExprVisitor {
     public:
-        std::shared_ptr<Expr> fold(std::shared_ptr<Expr> expr) {
+        explicit Optimizer(AstArena &arena) : arena(arena) {}
+
+        Expr *fold(Expr *expr) {
             expr->accept(*this);
             return lastFolded;
         }
@@ -35,6 +38,7 @@ namespace Backend {
     
 
     private:
-        std::shared_ptr<Expr> lastFolded;
+        AstArena &arena; // Where a folded constant is allocated
+        Expr *lastFolded;
     };
 }
\ No newline at end of file
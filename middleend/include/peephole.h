@@ -0,0 +1,15 @@
+#ifndef ry_peephole_h
+#define ry_peephole_h
+
+#include "chunk.h"
+
+namespace RyRuntime {
+	/*
+	 * Fuses hot instruction sequences of a finished chunk into superinstructions.
+	 * Jumps are re-targeted, and every fused byte keeps the line/column of the
+	 * instruction that can raise the error, so reports still point at the same source.
+	 */
+	void optimizeChunk(Chunk &chunk);
+} // namespace RyRuntime
+
+#endif
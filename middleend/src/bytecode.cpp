@@ -0,0 +1,508 @@
+#include "bytecode.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+#include "chunk.h"
+#include "func.h"
+#include "globals.h"
+#include "memory.h"
+
+namespace RyRuntime {
+	namespace {
+		const char MAGIC[4] = {'R', 'Y', 'C', '\0'};
+		const uint32_t VERSION = 4; // Bump whenever the layout below or an opcode's encoding changes
+
+		// What wrote the file, a cache is never written over a bundle
+		enum : uint8_t { KIND_CACHE, KIND_BUNDLE };
+
+		// Constant tags
+		enum : uint8_t { CONST_NUMBER, CONST_STRING, CONST_FUNCTION, CONST_NULL, CONST_TRUE, CONST_FALSE, CONST_INTEGER };
+
+		// Every integer is little-endian regardless of the host
+		class Writer {
+		public:
+			std::string bytes;
+
+			void u8(uint8_t value) { bytes.push_back((char) value); }
+
+			void u32(uint32_t value) {
+				for (int i = 0; i < 4; i++)
+					u8((value >> (i * 8)) & 0xff);
+			}
+
+			void u64(uint64_t value) {
+				for (int i = 0; i < 8; i++)
+					u8((value >> (i * 8)) & 0xff);
+			}
+
+			void string(std::string_view value) {
+				u32((uint32_t) value.size());
+				bytes.append(value);
+			}
+		};
+
+		// Fails by setting ok and returning zeros, callers check ok once at the end
+		class Reader {
+		public:
+			explicit Reader(const std::string &bytes) : bytes(bytes) {}
+
+			bool ok = true;
+
+			uint8_t u8() {
+				if (position >= bytes.size()) {
+					ok = false;
+					return 0;
+				}
+				return (uint8_t) bytes[position++];
+			}
+
+			uint32_t u32() {
+				uint32_t value = 0;
+				for (int i = 0; i < 4; i++)
+					value |= (uint32_t) u8() << (i * 8);
+				return value;
+			}
+
+			uint64_t u64() {
+				uint64_t value = 0;
+				for (int i = 0; i < 8; i++)
+					value |= (uint64_t) u8() << (i * 8);
+				return value;
+			}
+
+			std::string string() {
+				uint32_t size = u32();
+				if (!ok || size > bytes.size() - position) {
+					ok = false;
+					return "";
+				}
+				std::string value = bytes.substr(position, size);
+				position += size;
+				return value;
+			}
+
+			size_t offset() const { return position; }
+
+			// Guards vector sizes read from the file against a damaged count
+			bool fits(uint32_t count, size_t elementSize) {
+				if (count > (bytes.size() - position) / elementSize)
+					ok = false;
+				return ok;
+			}
+
+		private:
+			const std::string &bytes;
+			size_t position = 0;
+		};
+
+		// The symbols a file refers to, numbered in order of first use
+		class SymbolList {
+		public:
+			explicit SymbolList(SymbolTable &table) : table(table) {}
+
+			uint16_t indexOf(int slot) {
+				auto found = indexes.find(slot);
+				if (found != indexes.end())
+					return found->second;
+				uint16_t index = (uint16_t) names.size();
+				names.push_back(table.nameOf(slot));
+				indexes[slot] = index;
+				return index;
+			}
+
+			std::vector<std::string> names;
+
+		private:
+			SymbolTable &table;
+			std::unordered_map<int, uint16_t> indexes; // Process slot -> file index
+		};
+
+		// Quickened opcodes depend on what this process has executed, the file keeps the generic form
+		uint8_t genericOpcode(uint8_t op) {
+			switch (op) {
+				case OP_ADD_NUM_NUM:
+				case OP_ADD_STR_STR:
+					return OP_ADD;
+				case OP_LESS_NUM_NUM:
+					return OP_LESS;
+				default:
+					return op;
+			}
+		}
+
+		// Operands holding a global slot or a method symbol
+		bool isGlobalOp(uint8_t op) { return op == OP_DEFINE_GLOBAL || op == OP_GET_GLOBAL || op == OP_SET_GLOBAL; }
+
+		// Rewrites the 2-byte symbol at offset + 1 through map
+		template<typename Map>
+		void remapSymbol(std::vector<uint8_t> &code, size_t offset, Map map) {
+			int symbol = map((code[offset + 1] << 8) | code[offset + 2]);
+			code[offset + 1] = (symbol >> 8) & 0xff;
+			code[offset + 2] = symbol & 0xff;
+		}
+
+		struct Encoder {
+			Writer body;
+			SymbolList globals{globalNames()};
+			SymbolList methods{methodNames()};
+
+			bool function(Frontend::RyFunction *source) {
+				const Chunk &chunk = source->chunk;
+				body.string(source->name);
+				body.u32((uint32_t) source->arity);
+				body.u32((uint32_t) source->upvalueCount);
+
+				// Constants first, the reader needs them to walk OP_CLOSURE
+				body.u32((uint32_t) chunk.constants.size());
+				for (const RyValue &constant: chunk.constants) {
+					if (constant.isInt()) {
+						body.u8(CONST_INTEGER);
+						body.u64((uint64_t) constant.asInt());
+					} else if (constant.isNumber()) {
+						body.u8(CONST_NUMBER);
+						double number = constant.asNumber();
+						uint64_t bits;
+						std::memcpy(&bits, &number, sizeof bits);
+						body.u64(bits);
+					} else if (constant.isString()) {
+						body.u8(CONST_STRING);
+						body.string(constant.asString());
+					} else if (constant.isFunction()) {
+						body.u8(CONST_FUNCTION);
+						if (!function(constant.asFunction()))
+							return false;
+					} else if (constant.isNil()) {
+						body.u8(CONST_NULL);
+					} else if (constant.isBool()) {
+						body.u8(constant.asBool() ? CONST_TRUE : CONST_FALSE);
+					} else {
+						return false;
+					}
+				}
+
+				std::vector<uint8_t> code = chunk.code;
+				for (size_t offset = 0; offset < code.size(); offset += instructionLength(chunk, (int) offset)) {
+					code[offset] = genericOpcode(code[offset]);
+					if (isGlobalOp(code[offset]))
+						remapSymbol(code, offset, [&](int slot) { return globals.indexOf(slot); });
+					else if (code[offset] == OP_METHOD)
+						remapSymbol(code, offset, [&](int slot) { return methods.indexOf(slot); });
+				}
+				body.u32((uint32_t) code.size());
+				body.bytes.append(code.begin(), code.end());
+				for (size_t i = 0; i < code.size(); i++) {
+					body.u32((uint32_t) chunk.lines[i]);
+					body.u32((uint32_t) chunk.columns[i]);
+				}
+				body.u32((uint32_t) chunk.propertyCaches.size());
+				return true;
+			}
+		};
+
+		struct Decoder {
+			explicit Decoder(Reader &in) : in(in) {}
+
+			Reader &in;
+			std::vector<int> globals; // File index -> process slot
+			std::vector<int> methods;
+			int depth = 0;
+
+			Frontend::RyFunction *function() {
+				if (++depth > 256) // Nesting that deep only comes from a damaged file
+					in.ok = false;
+				auto result = allocateObject<Frontend::RyFunction>();
+				result->name = in.string();
+				result->arity = (int) in.u32();
+				result->upvalueCount = (int) in.u32();
+				Chunk &chunk = result->chunk;
+
+				uint32_t constantCount = in.u32();
+				if (!in.fits(constantCount, 1) || constantCount > UINT8_MAX + 1)
+					return fail();
+				for (uint32_t i = 0; i < constantCount && in.ok; i++) {
+					switch (in.u8()) {
+						case CONST_NUMBER: {
+							uint64_t bits = in.u64();
+							double number;
+							std::memcpy(&number, &bits, sizeof number);
+							chunk.constants.push_back(RyValue(number));
+							break;
+						}
+						case CONST_STRING:
+							chunk.constants.push_back(RyValue(in.string()));
+							break;
+						case CONST_FUNCTION: {
+							Frontend::RyFunction *nested = function();
+							if (nested == nullptr)
+								return fail();
+							chunk.constants.push_back(RyValue(nested));
+							break;
+						}
+						case CONST_NULL:
+							chunk.constants.push_back(RyValue(std::nullptr_t{}));
+							break;
+						case CONST_TRUE:
+							chunk.constants.push_back(RyValue(true));
+							break;
+						case CONST_FALSE:
+							chunk.constants.push_back(RyValue(false));
+							break;
+						case CONST_INTEGER:
+							chunk.constants.push_back(RyValue::integer((int64_t) in.u64()));
+							break;
+						default:
+							return fail();
+					}
+				}
+
+				uint32_t codeSize = in.u32();
+				if (!in.fits(codeSize, 9)) // A byte plus its line and column
+					return fail();
+				chunk.code.resize(codeSize);
+				for (uint32_t i = 0; i < codeSize; i++)
+					chunk.code[i] = in.u8();
+				chunk.lines.resize(codeSize);
+				chunk.columns.resize(codeSize);
+				for (uint32_t i = 0; i < codeSize; i++) {
+					chunk.lines[i] = (int) in.u32();
+					chunk.columns[i] = (int) in.u32();
+				}
+				if (!in.ok || !remapCode(chunk))
+					return fail();
+
+				uint32_t cacheCount = in.u32();
+				if (cacheCount > UINT16_MAX + 1)
+					return fail();
+				chunk.propertyCaches.resize(cacheCount);
+				depth--;
+				return in.ok ? result : nullptr;
+			}
+
+			// Validates the instruction stream while mapping file symbols back to process slots
+			bool remapCode(Chunk &chunk) {
+				size_t offset = 0;
+				while (offset < chunk.code.size()) {
+					uint8_t op = chunk.code[offset];
+					if (op >= OP_COUNT)
+						return false;
+					if (op == OP_CLOSURE) {
+						if (offset + 1 >= chunk.code.size() || chunk.code[offset + 1] >= chunk.constants.size() ||
+							!chunk.constants[chunk.code[offset + 1]].isFunction())
+							return false;
+					}
+					size_t length = instructionLength(chunk, (int) offset);
+					if (offset + length > chunk.code.size())
+						return false;
+
+					std::vector<int> *symbols = isGlobalOp(op) ? &globals : op == OP_METHOD ? &methods : nullptr;
+					if (symbols != nullptr) {
+						bool known = true;
+						remapSymbol(chunk.code, offset, [&](int index) {
+							if (index >= (int) symbols->size()) {
+								known = false;
+								return 0;
+							}
+							return (*symbols)[index];
+						});
+						if (!known)
+							return false;
+					}
+					offset += length;
+				}
+				return true;
+			}
+
+			Frontend::RyFunction *fail() {
+				in.ok = false;
+				return nullptr;
+			}
+		};
+
+		void writeNames(Writer &out, const std::vector<std::string> &names) {
+			out.u32((uint32_t) names.size());
+			for (const std::string &name: names)
+				out.string(name);
+		}
+
+		bool readNames(Reader &in, SymbolTable &table, std::vector<int> &slots) {
+			uint32_t count = in.u32();
+			if (!in.fits(count, 4))
+				return false;
+			for (uint32_t i = 0; i < count && in.ok; i++) {
+				int slot = table.slotFor(in.string());
+				if (slot < 0)
+					return false; // Compiling the source instead reports the full table
+				slots.push_back(slot);
+			}
+			return in.ok;
+		}
+	} // namespace
+
+	uint64_t hashSource(std::string_view source) {
+		// FNV-1a
+		uint64_t hash = 14695981039346656037ull;
+		for (char c: source) {
+			hash ^= (uint8_t) c;
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	namespace {
+		// script.ry -> script + suffix
+		std::string besideScript(const std::string &scriptPath, const char *suffix) {
+			if (scriptPath.size() > 3 && scriptPath.compare(scriptPath.size() - 3, 3, ".ry") == 0)
+				return scriptPath.substr(0, scriptPath.size() - 3) + suffix;
+			return scriptPath + suffix;
+		}
+
+		// Only reads the header, so a damaged bundle still counts. Older versions did not record the kind
+		bool isBundle(const std::string &path) {
+			std::ifstream file(path, std::ios::binary);
+			std::string header(sizeof MAGIC + 9, '\0');
+			if (!file.read(header.data(), (std::streamsize) header.size()))
+				return false;
+			Reader in(header);
+			for (char c: MAGIC) {
+				if ((char) in.u8() != c)
+					return false;
+			}
+			return in.u32() == VERSION && in.u32() == OP_COUNT && in.u8() == KIND_BUNDLE;
+		}
+
+		bool write(const std::string &path, Frontend::RyFunction *function, uint64_t sourceHash,
+							 const std::vector<BundledModule> &modules, uint8_t kind) {
+			Encoder encoder;
+			if (!encoder.function(function))
+				return false;
+			encoder.body.u32((uint32_t) modules.size());
+			for (const BundledModule &module: modules) {
+				encoder.body.string(module.path);
+				if (!encoder.function(module.function))
+					return false;
+			}
+
+			Writer out;
+			out.bytes.append(MAGIC, sizeof MAGIC);
+			out.u32(VERSION);
+			out.u32(OP_COUNT);
+			out.u8(kind);
+			out.u64(sourceHash);
+			size_t checked = out.bytes.size() + 8;
+			out.u64(0); // Checksum of everything after it, filled in below
+			writeNames(out, encoder.globals.names);
+			writeNames(out, encoder.methods.names);
+			out.bytes.append(encoder.body.bytes);
+			uint64_t checksum = hashSource(std::string_view(out.bytes).substr(checked));
+			for (int i = 0; i < 8; i++)
+				out.bytes[checked - 8 + i] = (char) ((checksum >> (i * 8)) & 0xff);
+
+			// Written aside and renamed, so a concurrent run never reads half a file
+			std::string temporary = path + ".tmp";
+			{
+				std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+				if (!file.is_open())
+					return false;
+				file.write(out.bytes.data(), (std::streamsize) out.bytes.size());
+				if (!file)
+					return false;
+			}
+			if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+				std::remove(temporary.c_str());
+				return false;
+			}
+			return true;
+		}
+	} // namespace
+
+	std::string bytecodePath(const std::string &scriptPath) { return besideScript(scriptPath, ".ryc"); }
+
+	std::string bundlePath(const std::string &scriptPath) { return besideScript(scriptPath, ".bundle.ryc"); }
+
+	bool writeBytecode(const std::string &path, Frontend::RyFunction *function, uint64_t sourceHash) {
+		if (isBundle(path))
+			return false;
+		return write(path, function, sourceHash, {}, KIND_CACHE);
+	}
+
+	bool writeBundle(const std::string &path, Frontend::RyFunction *function, uint64_t sourceHash,
+									 const std::vector<BundledModule> &modules) {
+		return write(path, function, sourceHash, modules, KIND_BUNDLE);
+	}
+
+	namespace {
+		// Skips the source hash check when sourceHash is null
+		Frontend::RyFunction *load(const std::string &path, const uint64_t *sourceHash,
+															 std::vector<BundledModule> &modules) {
+			std::ifstream file(path, std::ios::binary);
+			if (!file.is_open())
+				return nullptr;
+			std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+			Reader in(bytes);
+			for (char c: MAGIC) {
+				if ((char) in.u8() != c)
+					return nullptr;
+			}
+			if (in.u32() != VERSION || in.u32() != OP_COUNT)
+				return nullptr;
+			in.u8(); // Either kind loads, a bundle run as a script's cache just ignores its modules
+			uint64_t hash = in.u64();
+			if (sourceHash != nullptr && hash != *sourceHash)
+				return nullptr;
+			uint64_t checksum = in.u64();
+			if (!in.ok || hashSource(std::string_view(bytes).substr(in.offset())) != checksum)
+				return nullptr; // Truncated or damaged
+
+			Decoder decoder(in);
+			if (!readNames(in, globalNames(), decoder.globals) || !readNames(in, methodNames(), decoder.methods))
+				return nullptr;
+			Frontend::RyFunction *function = decoder.function();
+			uint32_t moduleCount = in.u32();
+			if (!in.fits(moduleCount, 4))
+				return nullptr;
+			for (uint32_t i = 0; i < moduleCount && in.ok; i++) {
+				std::string modulePath = in.string();
+				Frontend::RyFunction *module = decoder.function();
+				modules.push_back({modulePath, module});
+			}
+			return in.ok ? function : nullptr;
+		}
+
+		void collectImports(Frontend::RyFunction *function, std::vector<std::string> &paths) {
+			const Chunk &chunk = function->chunk;
+			int previous = -1;
+			for (int offset = 0; offset < (int) chunk.code.size(); offset += instructionLength(chunk, offset)) {
+				// The compiler emits the module expression right before OP_IMPORT
+				if (chunk.code[offset] == OP_IMPORT && previous != -1 && chunk.code[previous] == OP_CONSTANT) {
+					RyValue path = chunk.constants[chunk.code[previous + 1]];
+					if (path.isString())
+						paths.emplace_back(path.asString());
+				}
+				previous = offset;
+			}
+			for (const RyValue &constant: chunk.constants) {
+				if (constant.isFunction())
+					collectImports(constant.asFunction(), paths);
+			}
+		}
+	} // namespace
+
+	Frontend::RyFunction *readBytecode(const std::string &path, uint64_t sourceHash) {
+		std::vector<BundledModule> modules;
+		return load(path, &sourceHash, modules);
+	}
+
+	Frontend::RyFunction *readBundle(const std::string &path, std::vector<BundledModule> &modules) {
+		return load(path, nullptr, modules);
+	}
+
+	std::vector<std::string> importedPaths(Frontend::RyFunction *function) {
+		std::vector<std::string> paths;
+		collectImports(function, paths);
+		return paths;
+	}
+} // namespace RyRuntime
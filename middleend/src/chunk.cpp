@@ -0,0 +1,55 @@
+#include "chunk.h"
+#include "func.h"
+
+namespace RyRuntime {
+	int instructionLength(const Chunk &chunk, int offset) {
+		switch (chunk.code[offset]) {
+			case OP_CONSTANT:
+			case OP_GET_LOCAL:
+			case OP_SET_LOCAL:
+			case OP_GET_UPVALUE:
+			case OP_SET_UPVALUE:
+			case OP_CALL:
+			case OP_TAIL_CALL:
+			case OP_CLASS:
+			case OP_BUILD_LIST:
+			case OP_BUILD_MAP:
+			case OP_INC_LOCAL:
+				return 2;
+			case OP_METHOD:
+			case OP_DEFINE_GLOBAL:
+			case OP_GET_GLOBAL:
+			case OP_SET_GLOBAL:
+			case OP_JUMP:
+			case OP_JUMP_IF_FALSE:
+			case OP_LOOP:
+			case OP_FOR_EACH_NEXT:
+			case OP_ATTEMPT:
+			case OP_ADD_LOCAL_CONST:
+			case OP_JUMP_IF_NOT_LESS:
+				return 3;
+			case OP_GET_PROPERTY:
+			case OP_SET_PROPERTY:
+			case OP_ADD_RR:
+			case OP_ADD_RK:
+			case OP_SUBTRACT_RR:
+			case OP_SUBTRACT_RK:
+			case OP_MULTIPLY_RR:
+			case OP_MULTIPLY_RK:
+			case OP_LESS_RR:
+			case OP_LESS_RK:
+				return 4;
+			case OP_INVOKE:
+			case OP_JUMP_IF_NOT_LESS_LOCAL_CONST:
+			case OP_JUMP_IF_NOT_LESS_LOCAL_LOCAL:
+				return 5;
+			case OP_CLOSURE: {
+				// Followed by an (isLocal, index) pair per upvalue
+				Frontend::RyFunction *function = chunk.constants[chunk.code[offset + 1]].asFunction();
+				return 2 + function->upvalueCount * 2;
+			}
+			default:
+				return 1;
+		}
+	}
+} // namespace RyRuntime
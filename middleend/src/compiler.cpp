@@ -4,6 +4,7 @@
 #include "chunk.h"
 #include "class.h"
 #include "func.h"
+#include "peephole.h"
 #include "stmt.h"
 #include "token.h"
 #include "tools.h"
@@ -11,7 +12,7 @@
 using namespace Backend;
 
 namespace RyRuntime {
-	bool Compiler::compile(const std::vector<std::shared_ptr<Backend::Stmt>> &statements, Chunk *chunk) {
+	bool Compiler::compile(const std::vector<Backend::Stmt *> &statements, Chunk *chunk) {
 		this->compilingChunk = chunk;
 		this->locals.clear();
 		this->scopeDepth = 0;
@@ -24,24 +25,26 @@ namespace RyRuntime {
 		}
 
 		emitByte(OP_RETURN);
-		return true; // Return false if there's a compilation error
+		optimizeChunk(*chunk);
+		return !failed;
 	}
 
-	void Compiler::compileStatement(std::shared_ptr<Backend::Stmt> stmt) {
+	void Compiler::compileStatement(Backend::Stmt *stmt) {
 		if (stmt)
 			stmt->accept(*this);
 	}
 
-	void Compiler::compileExpression(std::shared_ptr<Backend::Expr> expr) {
+	void Compiler::compileExpression(Backend::Expr *expr) {
 		if (expr)
 			expr->accept(*this);
 	}
-	void Compiler::compileMethod(std::shared_ptr<Backend::FunctionStmt> stmt) {
+	void Compiler::compileMethod(Backend::FunctionStmt *stmt) {
 		track(stmt->name);
 
 		Compiler subCompiler(this, this->sourceCode);
 		subCompiler.currentClass = this->currentClass;
-		auto function = std::make_shared<Frontend::RyFunction>();
+		subCompiler.tailCalls = stmt->name.lexeme != "init";
+		auto function = allocateObject<Frontend::RyFunction>();
 		function->name = stmt->name.lexeme;
 		function->arity = stmt->parameters.size();
 
@@ -64,8 +67,10 @@ namespace RyRuntime {
 		subCompiler.emitByte(OP_NULL);
 		subCompiler.emitByte(OP_RETURN);
 		subCompiler.endScope();
+		optimizeChunk(function->chunk);
 
 		emitBytes(OP_CLOSURE, (uint8_t) makeConstant(RyValue(function)));
+		function->upvalueCount = subCompiler.upvalues.size();
 
 		// Emit upvalue data
 		for (int i = 0; i < subCompiler.upvalues.size(); i++) {
@@ -94,6 +99,88 @@ namespace RyRuntime {
 		return constant;
 	}
 
+	void Compiler::emitGlobal(uint8_t instruction, std::string_view name) {
+		int slot = globalNames().slotFor(std::string(name));
+		if (slot < 0) {
+			errorAtCurrent("Too many global variables.");
+			slot = 0;
+		}
+		emitByte(instruction);
+		emitByte((slot >> 8) & 0xff);
+		emitByte(slot & 0xff);
+	}
+
+	void Compiler::emitProperty(uint8_t instruction, std::string_view name, int argCount) {
+		int cache = (int) compilingChunk->propertyCaches.size();
+		if (cache > UINT16_MAX) {
+			std::cerr << "Too many property accesses in one chunk!" << std::endl;
+			cache = 0;
+		} else {
+			compilingChunk->propertyCaches.emplace_back();
+		}
+		emitBytes(instruction, (uint8_t) makeConstant(RyValue(std::string(name))));
+		if (instruction == OP_INVOKE)
+			emitByte((uint8_t) argCount);
+		emitByte((cache >> 8) & 0xff);
+		emitByte(cache & 0xff);
+	}
+
+	int Compiler::registerOperand(Expr *expr) {
+		auto variable = dynamic_cast<VariableExpr *>(expr);
+		if (!variable)
+			return -1;
+		return resolveLocal(variable->name);
+	}
+
+	bool Compiler::emitRegisterBinary(uint8_t dst, MathExpr &expr) {
+		uint8_t registerOp;
+		uint8_t constantOp;
+		switch (expr.op_t.type) {
+			case TokenType::PLUS:
+				registerOp = OP_ADD_RR;
+				constantOp = OP_ADD_RK;
+				break;
+			case TokenType::MINUS:
+				registerOp = OP_SUBTRACT_RR;
+				constantOp = OP_SUBTRACT_RK;
+				break;
+			case TokenType::STAR:
+				registerOp = OP_MULTIPLY_RR;
+				constantOp = OP_MULTIPLY_RK;
+				break;
+			case TokenType::LESS:
+				registerOp = OP_LESS_RR;
+				constantOp = OP_LESS_RK;
+				break;
+			default:
+				return false;
+		}
+
+		int a = registerOperand(expr.left);
+		if (a == -1)
+			return false;
+
+		int b = registerOperand(expr.right);
+		auto literal = dynamic_cast<ValueExpr *>(expr.right);
+		if (b == -1 && !(literal && literal->value.type == TokenType::NUMBER))
+			return false;
+
+		// Errors point at the right operand, like the stack form
+		if (b != -1) {
+			track(dynamic_cast<VariableExpr *>(expr.right)->name);
+			emitByte(registerOp);
+			emitBytes(dst, (uint8_t) a);
+			emitByte((uint8_t) b);
+		} else {
+			track(literal->value);
+			int constant = makeConstant(RyValue::number(std::stod(std::string(literal->value.lexeme))));
+			emitByte(constantOp);
+			emitBytes(dst, (uint8_t) a);
+			emitByte((uint8_t) constant);
+		}
+		return true;
+	}
+
 	int Compiler::emitJump(uint8_t instruction) {
 		emitByte(instruction);
 		emitByte(0xff);
@@ -177,8 +264,7 @@ namespace RyRuntime {
 		}
 
 		if (upvalues.size() == 256) {
-			RyTools::report(currentLine, currentColumn, "", "Too many closure variables in function.", sourceCode);
-			RyTools::hadError = true;
+			errorAtCurrent("Too many closure variables in function.");
 			return 0;
 		}
 
@@ -194,6 +280,15 @@ namespace RyRuntime {
 		RyTools::report(token.line, token.column, "", message, this->sourceCode);
 
 		RyTools::hadError = true;
+		for (Compiler *compiler = this; compiler != nullptr; compiler = compiler->enclosing)
+			compiler->failed = true;
+	}
+
+	void Compiler::errorAtCurrent(const std::string &message) {
+		Backend::Token token;
+		token.line = currentLine;
+		token.column = currentColumn;
+		error(token, message);
 	}
 
 	void Compiler::track(Token token) {
@@ -206,6 +301,9 @@ namespace RyRuntime {
 	void Compiler::visitMath(MathExpr &expr) {
 		track(expr.op_t);
 
+		if (emitRegisterBinary(REG_PUSH, expr))
+			return;
+
 		compileExpression(expr.left);
 		compileExpression(expr.right);
 
@@ -252,7 +350,7 @@ namespace RyRuntime {
 
 	void Compiler::visitVariable(VariableExpr &expr) {
 		track(expr.name);
-		std::string name = expr.name.lexeme;
+		std::string name(expr.name.lexeme);
 
 		int arg = resolveLocal(expr.name);
 		if (arg != -1) {
@@ -267,7 +365,7 @@ namespace RyRuntime {
 		}
 
 		if (name.find("::") != std::string::npos) {
-			emitBytes(OP_GET_GLOBAL, (uint8_t) makeConstant(RyValue(name)));
+			emitGlobal(OP_GET_GLOBAL, name);
 			return;
 		}
 
@@ -277,7 +375,7 @@ namespace RyRuntime {
 			name = currentNamespace + "::" + name;
 		}
 
-		emitBytes(OP_GET_GLOBAL, (uint8_t) makeConstant(RyValue(name)));
+		emitGlobal(OP_GET_GLOBAL, name);
 	}
 
 	void Compiler::visitValue(ValueExpr &expr) {
@@ -290,10 +388,11 @@ namespace RyRuntime {
 		} else if (expr.value.type == TokenType::NULL_TOKEN) {
 			emitByte(OP_NULL);
 		} else if (expr.value.type == TokenType::NUMBER) {
-			double val = std::stod(expr.value.lexeme);
-			emitConstant(RyValue(val));
+			// Whole literals become integers, 2.0 included
+			double val = std::stod(std::string(expr.value.lexeme));
+			emitConstant(RyValue::number(val));
 		} else if (expr.value.type == TokenType::STRING) {
-			emitConstant(RyValue(expr.value.lexeme));
+			emitConstant(RyValue(std::string(expr.value.lexeme)));
 		}
 	}
 
@@ -336,8 +435,14 @@ namespace RyRuntime {
 
 	void Compiler::visitAssign(AssignExpr &expr) {
 		track(expr.name);
-		compileExpression(expr.value);
 		int arg = resolveLocal(expr.name);
+
+		// local = a op b can write straight into the local's slot
+		auto math = dynamic_cast<MathExpr *>(expr.value);
+		if (arg != -1 && arg != REG_PUSH && math && emitRegisterBinary((uint8_t) arg, *math))
+			return;
+
+		compileExpression(expr.value);
 		if (arg != -1) {
 			emitBytes(OP_SET_LOCAL, (uint8_t) arg);
 			return;
@@ -349,19 +454,30 @@ namespace RyRuntime {
 		}
 
 		if (expr.name.lexeme.find("::") != std::string::npos) {
-			emitBytes(OP_SET_GLOBAL, (uint8_t) makeConstant(RyValue(expr.name.lexeme)));
+			emitGlobal(OP_SET_GLOBAL, expr.name.lexeme);
 		} else {
-			std::string name = expr.name.lexeme;
+			std::string name(expr.name.lexeme);
 
 			if (name.find("::") == std::string::npos && !currentNamespace.empty()) {
 				name = currentNamespace + "::" + name;
 			}
 
-			emitBytes(OP_SET_GLOBAL, (uint8_t) makeConstant(RyValue(name)));
+			emitGlobal(OP_SET_GLOBAL, name);
 		}
 	}
 
 	void Compiler::visitCall(CallExpr &expr) {
+		// obj.name(args) looks the method up and calls it in one instruction, without a bound method
+		if (auto get = dynamic_cast<GetExpr *>(expr.callee)) {
+			compileExpression(get->object);
+			for (const auto &arg: expr.arguments) {
+				compileExpression(arg);
+			}
+			track(get->name);
+			emitProperty(OP_INVOKE, get->name.lexeme, (int) expr.arguments.size());
+			return;
+		}
+
 		track(expr.Paren);
 		compileExpression(expr.callee);
 		for (const auto &arg: expr.arguments) {
@@ -372,8 +488,8 @@ namespace RyRuntime {
 
 	void Compiler::visitExpressionStmt(ExpressionStmt &stmt) {
 		compileExpression(stmt.expression);
-		if (std::dynamic_pointer_cast<AssignExpr>(stmt.expression) ||
-				std::dynamic_pointer_cast<IndexSetExpr>(stmt.expression)) {
+		if (dynamic_cast<AssignExpr *>(stmt.expression) ||
+				dynamic_cast<IndexSetExpr *>(stmt.expression)) {
 			return;
 		}
 		emitByte(OP_POP);
@@ -480,9 +596,9 @@ namespace RyRuntime {
 		}
 
 		if (scopeDepth > 0) {
-			std::string name = stmt.name.lexeme;
+			std::string_view name = stmt.name.lexeme;
 			size_t lastColon = name.find_last_of(':');
-			if (lastColon != std::string::npos) {
+			if (lastColon != std::string_view::npos) {
 				Token baseName = stmt.name;
 				baseName.lexeme = name.substr(lastColon + 1);
 				addLocal(baseName);
@@ -490,13 +606,25 @@ namespace RyRuntime {
 				addLocal(stmt.name);
 			}
 		} else {
-			std::string name = stmt.name.lexeme;
-			emitBytes(OP_DEFINE_GLOBAL, (uint8_t) makeConstant(RyValue(name)));
+			emitGlobal(OP_DEFINE_GLOBAL, stmt.name.lexeme);
 		}
 	}
 
 	void Compiler::visitReturnStmt(ReturnStmt &stmt) {
 		track(stmt.keyword);
+		auto call = dynamic_cast<CallExpr *>(stmt.value);
+		if (call && tailCalls && attemptDepth == 0 && !dynamic_cast<GetExpr *>(call->callee)) {
+			// The OP_RETURN is still needed after callees that do not take over the frame
+			track(call->Paren);
+			compileExpression(call->callee);
+			for (const auto &arg: call->arguments) {
+				compileExpression(arg);
+			}
+			emitBytes(OP_TAIL_CALL, (uint8_t) call->arguments.size());
+			emitByte(OP_RETURN);
+			return;
+		}
+
 		if (stmt.value)
 			compileExpression(stmt.value);
 		else
@@ -529,11 +657,11 @@ namespace RyRuntime {
 		classCompiler->enclosing = currentClass;
 		currentClass = classCompiler;
 
-		uint8_t nameConst = (uint8_t) makeConstant(RyValue(stmt.name.lexeme));
+		uint8_t nameConst = (uint8_t) makeConstant(RyValue(std::string(stmt.name.lexeme)));
 		emitBytes(OP_CLASS, nameConst);
-		emitBytes(OP_DEFINE_GLOBAL, nameConst);
+		emitGlobal(OP_DEFINE_GLOBAL, stmt.name.lexeme);
 
-		emitBytes(OP_GET_GLOBAL, nameConst);
+		emitGlobal(OP_GET_GLOBAL, stmt.name.lexeme);
 
 		if (stmt.superclass != nullptr) {
 			compileExpression(stmt.superclass);
@@ -545,8 +673,14 @@ namespace RyRuntime {
 		for (const auto &method: stmt.methods) {
 			compileMethod(method);
 
-			uint8_t methodConst = (uint8_t) makeConstant(RyValue(method->name.lexeme));
-			emitBytes(OP_METHOD, methodConst);
+			int symbol = methodNames().slotFor(std::string(method->name.lexeme));
+			if (symbol < 0) {
+				error(method->name, "Too many method names.");
+				symbol = 0;
+			}
+			emitByte(OP_METHOD);
+			emitByte((symbol >> 8) & 0xff);
+			emitByte(symbol & 0xff);
 		}
 
 		currentClass = currentClass->enclosing;
@@ -564,20 +698,21 @@ namespace RyRuntime {
 	void Compiler::visitGet(GetExpr &expr) {
 		track(expr.name);
 		compileExpression(expr.object);
-		emitBytes(OP_GET_PROPERTY, (uint8_t) makeConstant(RyValue(expr.name.lexeme)));
+		emitProperty(OP_GET_PROPERTY, expr.name.lexeme);
 	}
 	void Compiler::visitSet(SetExpr &expr) {
 		track(expr.name);
 		compileExpression(expr.object);
 		compileExpression(expr.value);
-		emitBytes(OP_SET_PROPERTY, (uint8_t) makeConstant(RyValue(expr.name.lexeme)));
+		emitProperty(OP_SET_PROPERTY, expr.name.lexeme);
 	}
 	void Compiler::visitFunctionStmt(FunctionStmt &stmt) {
 		track(stmt.name);
 
 		Compiler subCompiler(this, this->sourceCode);
+		subCompiler.tailCalls = stmt.name.lexeme != "init";
 
-		auto function = std::make_shared<Frontend::RyFunction>();
+		auto function = allocateObject<Frontend::RyFunction>();
 		function->name = stmt.name.lexeme;
 		function->arity = stmt.parameters.size();
 
@@ -597,6 +732,14 @@ namespace RyRuntime {
 		subCompiler.emitByte(OP_NULL);
 		subCompiler.emitByte(OP_RETURN);
 		subCompiler.endScope();
+		optimizeChunk(function->chunk);
+
+		// A function that captures nothing is called as it is, without a closure
+		if (subCompiler.upvalues.empty()) {
+			emitConstant(RyValue(function));
+			emitGlobal(OP_DEFINE_GLOBAL, stmt.name.lexeme);
+			return;
+		}
 
 		emitBytes(OP_CLOSURE, (uint8_t) makeConstant(RyValue(function)));
 		function->upvalueCount = subCompiler.upvalues.size();
@@ -606,7 +749,7 @@ namespace RyRuntime {
 			emitByte(subCompiler.upvalues[i].index);
 		}
 
-		emitBytes(OP_DEFINE_GLOBAL, (uint8_t) makeConstant(RyValue(stmt.name.lexeme)));
+		emitGlobal(OP_DEFINE_GLOBAL, stmt.name.lexeme);
 	}
 	void Compiler::visitMap(MapExpr &expr) {
 		track(expr.braceToken);
@@ -657,7 +800,7 @@ namespace RyRuntime {
 
 		// Try to see if the left side is a variable
 		// Cast the 'left' Expr to a VariableExpr to get the name
-		auto var = std::dynamic_pointer_cast<VariableExpr>(expr.left);
+		auto var = dynamic_cast<VariableExpr *>(expr.left);
 
 		if (var) {
 			// Get the current value onto the stack
@@ -665,14 +808,14 @@ namespace RyRuntime {
 			if (arg != -1) {
 				emitBytes(OP_GET_LOCAL, (uint8_t) arg);
 			} else {
-				emitBytes(OP_GET_GLOBAL, (uint8_t) makeConstant(RyValue(var->name.lexeme)));
+				emitGlobal(OP_GET_GLOBAL, var->name.lexeme);
 			}
 
 			// Copy the value
 			emitByte(OP_COPY);
 
 			// Push the increment value
-			emitConstant(RyValue(1.0));
+			emitConstant(RyValue::integer(1));
 
 			// Add or Subtract
 			if (expr.postfix.type == TokenType::PLUS_PLUS) {
@@ -685,7 +828,7 @@ namespace RyRuntime {
 			if (arg != -1) {
 				emitBytes(OP_SET_LOCAL, (uint8_t) arg);
 			} else {
-				emitBytes(OP_SET_GLOBAL, (uint8_t) makeConstant(RyValue(var->name.lexeme)));
+				emitGlobal(OP_SET_GLOBAL, var->name.lexeme);
 			}
 
 		} else {
@@ -760,9 +903,8 @@ namespace RyRuntime {
 		// Evaluate the expression we are aliasing (e.g., Math.sqrt)
 		compileExpression(stmt.aliasExpr);
 
-		// Define it in the global map under the NEW name
-		uint8_t constant = (uint8_t) makeConstant(RyValue(stmt.name.lexeme));
-		emitBytes(OP_DEFINE_GLOBAL, constant);
+		// Define it as a global under the NEW name
+		emitGlobal(OP_DEFINE_GLOBAL, stmt.name.lexeme);
 	}
 	void Compiler::visitNamespaceStmt(NamespaceStmt &stmt) {
 		track(stmt.name);
@@ -777,7 +919,7 @@ namespace RyRuntime {
 	void Compiler::visitEachStmt(EachStmt &stmt) {
 		track(stmt.id);
 		compileExpression(stmt.collection);
-		emitConstant(RyValue(0.0));
+		emitConstant(RyValue::integer(0));
 
 		beginScope();
 		Token dummy;
@@ -818,9 +960,11 @@ namespace RyRuntime {
 
 		// Compile the 'attempt' body
 		beginScope();
+		attemptDepth++;
 		for (const auto &s: stmt.attemptBody) {
 			compileStatement(s);
 		}
+		attemptDepth--;
 		endScope();
 
 		// If we get here, no panic happened. Remove the safety net.
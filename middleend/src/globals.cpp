@@ -0,0 +1,36 @@
+#include "globals.h"
+
+namespace RyRuntime {
+	SymbolTable &globalNames() {
+		static SymbolTable instance;
+		return instance;
+	}
+
+	SymbolTable &methodNames() {
+		static SymbolTable instance = [] {
+			SymbolTable table;
+			table.slotFor("init"); // INIT_METHOD
+			return table;
+		}();
+		return instance;
+	}
+
+	int SymbolTable::slotFor(const std::string &name) {
+		auto it = slots.find(name);
+		if (it != slots.end())
+			return it->second;
+
+		if (size() == MAX_SLOTS)
+			return -1;
+
+		int slot = size();
+		names.push_back(name);
+		slots[name] = slot;
+		return slot;
+	}
+
+	int SymbolTable::find(const std::string &name) const {
+		auto it = slots.find(name);
+		return it == slots.end() ? -1 : it->second;
+	}
+} // namespace RyRuntime
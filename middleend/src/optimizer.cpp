@@ -4,15 +4,15 @@ using namespace Backend;
 
 void Optimizer::visitMath(MathExpr &expr) {
 	// Dig deeper first
-	auto left = fold(expr.left);
-	auto right = fold(expr.right);
+	Expr *left = expr.left = fold(expr.left);
+	Expr *right = expr.right = fold(expr.right);
 
 	// Try to case to see if they are constants
-	auto lVal = std::dynamic_pointer_cast<ValueExpr>(left);
-	auto rVal = std::dynamic_pointer_cast<ValueExpr>(right);
+	auto lVal = dynamic_cast<ValueExpr *>(left);
+	auto rVal = dynamic_cast<ValueExpr *>(right);
 	// Right-hand side identity check
 	if (rVal && rVal->value.type == TokenType::NUMBER) {
-		double val = std::stod(rVal->value.lexeme);
+		double val = std::stod(std::string(rVal->value.lexeme));
 		if ((expr.op_t.type == TokenType::PLUS || expr.op_t.type == TokenType::MINUS) && val == 0) {
 			lastFolded = left;
 			return;
@@ -26,8 +26,8 @@ void Optimizer::visitMath(MathExpr &expr) {
 
 	// If both are numbers, precompute
 	if (lVal && rVal && lVal->value.type == TokenType::NUMBER && rVal->value.type == TokenType::NUMBER) {
-		double ld = std::stod(lVal->value.lexeme);
-		double rd = std::stod(rVal->value.lexeme);
+		double ld = std::stod(std::string(lVal->value.lexeme));
+		double rd = std::stod(std::string(rVal->value.lexeme));
 		double result = 0;
 
 		switch (expr.op_t.type) {
@@ -42,99 +42,99 @@ void Optimizer::visitMath(MathExpr &expr) {
 				break;
 			case TokenType::DIVIDE:
 				if (rd == 0) {
-					lastFolded = std::make_shared<MathExpr>(left, expr.op_t, right);
+					lastFolded = &expr;
 					return;
 				}
 				result = ld / rd;
 				break;
 			default:
 				// If it's a comparison (> < ==), return the original tree
-				lastFolded = std::make_shared<MathExpr>(left, expr.op_t, right);
+				lastFolded = &expr;
 				return;
 		}
 
 		// Replace the whole branch with a single number
 		Token resultToken = expr.op_t;
 		resultToken.type = TokenType::NUMBER;
-		resultToken.lexeme = std::to_string(result);
-		lastFolded = std::make_shared<ValueExpr>(resultToken);
+		resultToken.lexeme = arena.keep(std::to_string(result));
+		lastFolded = arena.make<ValueExpr>(resultToken);
 		return;
 	}
 
 	// If we can't fold, return the tree but with optimized children
-	lastFolded = std::make_shared<MathExpr>(left, expr.op_t, right);
+	lastFolded = &expr;
 }
 void Optimizer::visitGroup(GroupExpr &expr) {
 	// Just return the folded inner expression, throwing away the ( )
 	lastFolded = fold(expr.expression);
 }
-void Optimizer::visitVariable(VariableExpr &expr) { lastFolded = std::make_shared<VariableExpr>(expr.name); }
+void Optimizer::visitVariable(VariableExpr &expr) { lastFolded = &expr; }
 
-void Optimizer::visitValue(ValueExpr &expr) { lastFolded = std::make_shared<ValueExpr>(expr.value); }
+void Optimizer::visitValue(ValueExpr &expr) { lastFolded = &expr; }
 
 void Optimizer::visitBitwiseOr(BitwiseOrExpr &expr) {
-	auto left = fold(expr.left);
-	auto right = fold(expr.right);
-	auto lVal = std::dynamic_pointer_cast<ValueExpr>(left);
-	auto rVal = std::dynamic_pointer_cast<ValueExpr>(right);
+	Expr *left = expr.left = fold(expr.left);
+	Expr *right = expr.right = fold(expr.right);
+	auto lVal = dynamic_cast<ValueExpr *>(left);
+	auto rVal = dynamic_cast<ValueExpr *>(right);
 
 	if (lVal && rVal && lVal->value.type == TokenType::NUMBER && rVal->value.type == TokenType::NUMBER) {
-		long l = static_cast<long>(std::stod(lVal->value.lexeme));
-		long r = static_cast<long>(std::stod(rVal->value.lexeme));
+		long l = static_cast<long>(std::stod(std::string(lVal->value.lexeme)));
+		long r = static_cast<long>(std::stod(std::string(rVal->value.lexeme)));
 		Token t = expr.op_t;
 		t.type = TokenType::NUMBER;
-		t.lexeme = std::to_string(static_cast<double>(l | r));
-		lastFolded = std::make_shared<ValueExpr>(t);
+		t.lexeme = arena.keep(std::to_string(static_cast<double>(l | r)));
+		lastFolded = arena.make<ValueExpr>(t);
 		return;
 	}
-	lastFolded = std::make_shared<BitwiseOrExpr>(left, expr.op_t, right);
+	lastFolded = &expr;
 }
 
 void Optimizer::visitBitwiseXor(BitwiseXorExpr &expr) {
-	auto left = fold(expr.left);
-	auto right = fold(expr.right);
-	auto lVal = std::dynamic_pointer_cast<ValueExpr>(left);
-	auto rVal = std::dynamic_pointer_cast<ValueExpr>(right);
+	Expr *left = expr.left = fold(expr.left);
+	Expr *right = expr.right = fold(expr.right);
+	auto lVal = dynamic_cast<ValueExpr *>(left);
+	auto rVal = dynamic_cast<ValueExpr *>(right);
 
 	if (lVal && rVal && lVal->value.type == TokenType::NUMBER && rVal->value.type == TokenType::NUMBER) {
-		long l = static_cast<long>(std::stod(lVal->value.lexeme));
-		long r = static_cast<long>(std::stod(rVal->value.lexeme));
+		long l = static_cast<long>(std::stod(std::string(lVal->value.lexeme)));
+		long r = static_cast<long>(std::stod(std::string(rVal->value.lexeme)));
 		Token t = expr.op_t;
 		t.type = TokenType::NUMBER;
-		t.lexeme = std::to_string(static_cast<double>(l ^ r));
-		lastFolded = std::make_shared<ValueExpr>(t);
+		t.lexeme = arena.keep(std::to_string(static_cast<double>(l ^ r)));
+		lastFolded = arena.make<ValueExpr>(t);
 		return;
 	}
-	lastFolded = std::make_shared<BitwiseXorExpr>(left, expr.op_t, right);
+	lastFolded = &expr;
 }
 
 void Optimizer::visitBitwiseAnd(BitwiseAndExpr &expr) {
-	auto left = fold(expr.left);
-	auto right = fold(expr.right);
-	auto lVal = std::dynamic_pointer_cast<ValueExpr>(left);
-	auto rVal = std::dynamic_pointer_cast<ValueExpr>(right);
+	Expr *left = expr.left = fold(expr.left);
+	Expr *right = expr.right = fold(expr.right);
+	auto lVal = dynamic_cast<ValueExpr *>(left);
+	auto rVal = dynamic_cast<ValueExpr *>(right);
 
 	if (lVal && rVal && lVal->value.type == TokenType::NUMBER && rVal->value.type == TokenType::NUMBER) {
-		long l = static_cast<long>(std::stod(lVal->value.lexeme));
-		long r = static_cast<long>(std::stod(rVal->value.lexeme));
+		long l = static_cast<long>(std::stod(std::string(lVal->value.lexeme)));
+		long r = static_cast<long>(std::stod(std::string(rVal->value.lexeme)));
 		Token t = expr.op_t;
 		t.type = TokenType::NUMBER;
-		t.lexeme = std::to_string(static_cast<double>(l & r));
-		lastFolded = std::make_shared<ValueExpr>(t);
+		t.lexeme = arena.keep(std::to_string(static_cast<double>(l & r)));
+		lastFolded = arena.make<ValueExpr>(t);
 		return;
 	}
-	lastFolded = std::make_shared<BitwiseAndExpr>(left, expr.op_t, right);
+	lastFolded = &expr;
 }
 
 void Optimizer::visitShift(ShiftExpr &expr) {
-	auto left = fold(expr.left);
-	auto right = fold(expr.right);
-	auto lVal = std::dynamic_pointer_cast<ValueExpr>(left);
-	auto rVal = std::dynamic_pointer_cast<ValueExpr>(right);
+	Expr *left = expr.left = fold(expr.left);
+	Expr *right = expr.right = fold(expr.right);
+	auto lVal = dynamic_cast<ValueExpr *>(left);
+	auto rVal = dynamic_cast<ValueExpr *>(right);
 
 	if (lVal && rVal && lVal->value.type == TokenType::NUMBER && rVal->value.type == TokenType::NUMBER) {
-		long l = static_cast<long>(std::stod(lVal->value.lexeme));
-		long r = static_cast<long>(std::stod(rVal->value.lexeme));
+		long l = static_cast<long>(std::stod(std::string(lVal->value.lexeme)));
+		long r = static_cast<long>(std::stod(std::string(rVal->value.lexeme)));
 		double result = 0;
 		if (expr.op_t.type == TokenType::LESS_LESS) {
 			result = static_cast<double>(l << r);
@@ -143,23 +143,23 @@ void Optimizer::visitShift(ShiftExpr &expr) {
 		}
 		Token t = expr.op_t;
 		t.type = TokenType::NUMBER;
-		t.lexeme = std::to_string(result);
-		lastFolded = std::make_shared<ValueExpr>(t);
+		t.lexeme = arena.keep(std::to_string(result));
+		lastFolded = arena.make<ValueExpr>(t);
 		return;
 	}
-	lastFolded = std::make_shared<ShiftExpr>(left, expr.op_t, right);
+	lastFolded = &expr;
 }
 
 void Optimizer::visitPrefix(PrefixExpr &expr) {
-	auto right = fold(expr.right);
-	auto rVal = std::dynamic_pointer_cast<ValueExpr>(right);
+	Expr *right = expr.right = fold(expr.right);
+	auto rVal = dynamic_cast<ValueExpr *>(right);
 
 	if (rVal) {
 		if (expr.prefix.type == TokenType::MINUS && rVal->value.type == TokenType::NUMBER) {
-			double d = std::stod(rVal->value.lexeme);
+			double d = std::stod(std::string(rVal->value.lexeme));
 			Token t = rVal->value;
-			t.lexeme = std::to_string(-d);
-			lastFolded = std::make_shared<ValueExpr>(t);
+			t.lexeme = arena.keep(std::to_string(-d));
+			lastFolded = arena.make<ValueExpr>(t);
 			return;
 		}
 		if (expr.prefix.type == TokenType::BANG) {
@@ -169,28 +169,28 @@ void Optimizer::visitPrefix(PrefixExpr &expr) {
 			Token t = expr.prefix;
 			t.type = (!truthy) ? TokenType::TRUE : TokenType::FALSE;
 			t.lexeme = (!truthy) ? "true" : "false";
-			lastFolded = std::make_shared<ValueExpr>(t);
+			lastFolded = arena.make<ValueExpr>(t);
 			return;
 		}
 		if (expr.prefix.type == TokenType::TILDE && rVal->value.type == TokenType::NUMBER) {
-			long l = static_cast<long>(std::stod(rVal->value.lexeme));
+			long l = static_cast<long>(std::stod(std::string(rVal->value.lexeme)));
 			Token t = rVal->value;
-			t.lexeme = std::to_string(static_cast<double>(~l));
-			lastFolded = std::make_shared<ValueExpr>(t);
+			t.lexeme = arena.keep(std::to_string(static_cast<double>(~l)));
+			lastFolded = arena.make<ValueExpr>(t);
 			return;
 		}
 	}
-	lastFolded = std::make_shared<PrefixExpr>(expr.prefix, right);
+	lastFolded = &expr;
 }
 
 void Optimizer::visitPostfix(PostfixExpr &expr) {
-	auto left = fold(expr.left);
-	lastFolded = std::make_shared<PostfixExpr>(expr.postfix, left);
+	expr.left = fold(expr.left);
+	lastFolded = &expr;
 }
 
 void Optimizer::visitLogical(LogicalExpr &expr) {
-	auto left = fold(expr.left);
-	auto lVal = std::dynamic_pointer_cast<ValueExpr>(left);
+	Expr *left = expr.left = fold(expr.left);
+	auto lVal = dynamic_cast<ValueExpr *>(left);
 
 	if (lVal) {
 		bool truthy = true;
@@ -210,68 +210,66 @@ void Optimizer::visitLogical(LogicalExpr &expr) {
 		}
 	}
 
-	auto right = fold(expr.right);
-	lastFolded = std::make_shared<LogicalExpr>(left, expr.op_t, right);
+	expr.right = fold(expr.right);
+	lastFolded = &expr;
 }
 
 void Optimizer::visitAssign(AssignExpr &expr) {
-	auto value = fold(expr.value);
-	lastFolded = std::make_shared<AssignExpr>(expr.name, value);
+	expr.value = fold(expr.value);
+	lastFolded = &expr;
 }
 
 void Optimizer::visitCall(CallExpr &expr) {
-	auto callee = fold(expr.callee);
-	std::vector<std::shared_ptr<Expr>> args;
+	expr.callee = fold(expr.callee);
 	for (auto &arg: expr.arguments) {
-		args.push_back(fold(arg));
+		arg = fold(arg);
 	}
-	lastFolded = std::make_shared<CallExpr>(callee, args, expr.Paren);
+	lastFolded = &expr;
 }
 
-void Optimizer::visitThis(ThisExpr &expr) { lastFolded = std::make_shared<ThisExpr>(expr.keyword); }
+void Optimizer::visitThis(ThisExpr &expr) { lastFolded = &expr; }
 
 void Optimizer::visitGet(GetExpr &expr) {
-	auto object = fold(expr.object);
-	lastFolded = std::make_shared<GetExpr>(object, expr.name);
+	expr.object = fold(expr.object);
+	lastFolded = &expr;
 }
 
 void Optimizer::visitMap(MapExpr &expr) {
-	std::vector<std::pair<std::shared_ptr<Expr>, std::shared_ptr<Expr>>> items;
 	for (auto &pair: expr.items) {
-		items.push_back({fold(pair.first), fold(pair.second)});
+		pair.first = fold(pair.first);
+		pair.second = fold(pair.second);
 	}
-	lastFolded = std::make_shared<MapExpr>(expr.braceToken, items);
+	lastFolded = &expr;
 }
 
 void Optimizer::visitRange(RangeExpr &expr) {
-	auto left = fold(expr.leftBound);
-	auto right = fold(expr.rightBound);
-	lastFolded = std::make_shared<RangeExpr>(left, expr.op_t, right);
+	expr.leftBound = fold(expr.leftBound);
+	expr.rightBound = fold(expr.rightBound);
+	lastFolded = &expr;
 }
 
 void Optimizer::visitSet(SetExpr &expr) {
-	auto object = fold(expr.object);
-	auto value = fold(expr.value);
-	lastFolded = std::make_shared<SetExpr>(object, expr.name, value);
+	expr.object = fold(expr.object);
+	expr.value = fold(expr.value);
+	lastFolded = &expr;
 }
 
 void Optimizer::visitIndexSet(IndexSetExpr &expr) {
-	auto object = fold(expr.object);
-	auto index = fold(expr.index);
-	auto value = fold(expr.value);
-	lastFolded = std::make_shared<IndexSetExpr>(object, expr.bracket, index, value);
+	expr.object = fold(expr.object);
+	expr.index = fold(expr.index);
+	expr.value = fold(expr.value);
+	lastFolded = &expr;
 }
 
 void Optimizer::visitIndex(IndexExpr &expr) {
-	auto object = fold(expr.object);
-	auto index = fold(expr.index);
-	lastFolded = std::make_shared<IndexExpr>(object, index, expr.bracket);
+	expr.object = fold(expr.object);
+	expr.index = fold(expr.index);
+	lastFolded = &expr;
 }
 
 void Optimizer::visitList(ListExpr &expr) {
-	std::vector<std::shared_ptr<Expr>> elements;
 	for (auto &el: expr.elements) {
-		elements.push_back(fold(el));
+		el = fold(el);
 	}
-	lastFolded = std::make_shared<ListExpr>(elements);
+	lastFolded = &expr;
 }
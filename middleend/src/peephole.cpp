@@ -0,0 +1,162 @@
+#include "peephole.h"
+
+namespace RyRuntime {
+	namespace {
+		// A jump copied into the new code whose offset still has to be recomputed
+		struct PendingJump {
+			int operand; // Where the 2-byte offset sits in the new code, always the last 2 bytes of the instruction
+			int target; // Old offset it jumps to
+			bool backward;
+		};
+
+		bool isJump(uint8_t instruction) {
+			switch (instruction) {
+				case OP_JUMP:
+				case OP_JUMP_IF_FALSE:
+				case OP_LOOP:
+				case OP_FOR_EACH_NEXT:
+				case OP_ATTEMPT:
+				case OP_JUMP_IF_NOT_LESS:
+				case OP_JUMP_IF_NOT_LESS_LOCAL_CONST:
+				case OP_JUMP_IF_NOT_LESS_LOCAL_LOCAL:
+					return true;
+				default:
+					return false;
+			}
+		}
+
+		// Jump offsets are relative to the end of the instruction
+		int jumpTarget(const Chunk &chunk, int offset) {
+			int end = offset + instructionLength(chunk, offset);
+			int jump = (chunk.code[end - 2] << 8) | chunk.code[end - 1];
+			return chunk.code[offset] == OP_LOOP ? end - jump : end + jump;
+		}
+
+		bool isOne(const Chunk &chunk, uint8_t constant) {
+			RyValue value = chunk.constants[constant];
+			return value.isNumber() && value.asNumber() == 1.0;
+		}
+	} // namespace
+
+	void optimizeChunk(Chunk &chunk) {
+		const std::vector<uint8_t> &code = chunk.code;
+		int size = (int) code.size();
+
+		std::vector<int> starts;
+		std::vector<bool> isTarget(size + 1, false);
+		for (int offset = 0; offset < size; offset += instructionLength(chunk, offset)) {
+			starts.push_back(offset);
+			if (isJump(code[offset]))
+				isTarget[jumpTarget(chunk, offset)] = true;
+		}
+
+		std::vector<uint8_t> newCode;
+		std::vector<int> newLines;
+		std::vector<int> newColumns;
+		std::vector<int> newOffset(size + 1, 0);
+		std::vector<PendingJump> jumps;
+		newCode.reserve(size);
+		newLines.reserve(size);
+		newColumns.reserve(size);
+
+		// Every byte of a fused instruction reports the position of the old instruction at anchor
+		auto emit = [&](uint8_t byte, int anchor) {
+			newCode.push_back(byte);
+			newLines.push_back(chunk.lines[anchor]);
+			newColumns.push_back(chunk.columns[anchor]);
+		};
+		auto emitJumpTo = [&](int target, int anchor) {
+			jumps.push_back({(int) newCode.size(), target, false});
+			emit(0xff, anchor);
+			emit(0xff, anchor);
+		};
+
+		int n = 0;
+		while (n < (int) starts.size()) {
+			// The k-th instruction from here, or -1 if it does not exist or something jumps into it
+			auto op = [&](int k) -> int {
+				if (n + k >= (int) starts.size() || (k > 0 && isTarget[starts[n + k]]))
+					return -1;
+				return code[starts[n + k]];
+			};
+			auto at = [&](int k) { return starts[n + k]; };
+			auto operand = [&](int k, int index) { return code[at(k) + 1 + index]; };
+
+			int fused = 0; // How many old instructions were replaced
+			int start = (int) newCode.size();
+
+			if (op(0) == OP_GET_LOCAL && op(1) == OP_COPY && op(2) == OP_CONSTANT && op(3) == OP_ADD &&
+					op(4) == OP_SET_LOCAL && op(5) == OP_POP && operand(0, 0) == operand(4, 0) && isOne(chunk, operand(2, 0))) {
+				// slot++ as a statement
+				emit(OP_INC_LOCAL, at(3));
+				emit(operand(0, 0), at(3));
+				fused = 6;
+			} else if (op(0) == OP_GET_LOCAL && op(1) == OP_CONSTANT && op(2) == OP_ADD && op(3) == OP_SET_LOCAL &&
+								 operand(0, 0) == operand(3, 0)) {
+				// slot = slot + K
+				if (isOne(chunk, operand(1, 0))) {
+					emit(OP_INC_LOCAL, at(2));
+					emit(operand(0, 0), at(2));
+				} else {
+					emit(OP_ADD_LOCAL_CONST, at(2));
+					emit(operand(0, 0), at(2));
+					emit(operand(1, 0), at(2));
+				}
+				fused = 4;
+			} else if (op(0) == OP_ADD_RK && operand(0, 0) != REG_PUSH && operand(0, 0) == operand(0, 1)) {
+				// The register form of slot = slot + K
+				if (isOne(chunk, operand(0, 2))) {
+					emit(OP_INC_LOCAL, at(0));
+					emit(operand(0, 1), at(0));
+				} else {
+					emit(OP_ADD_LOCAL_CONST, at(0));
+					emit(operand(0, 1), at(0));
+					emit(operand(0, 2), at(0));
+				}
+				fused = 1;
+			} else if ((op(0) == OP_LESS_RK || op(0) == OP_LESS_RR) && operand(0, 0) == REG_PUSH &&
+								 op(1) == OP_JUMP_IF_FALSE && op(2) == OP_POP) {
+				// Loop and if conditions on a local
+				emit(op(0) == OP_LESS_RK ? OP_JUMP_IF_NOT_LESS_LOCAL_CONST : OP_JUMP_IF_NOT_LESS_LOCAL_LOCAL, at(0));
+				emit(operand(0, 1), at(0));
+				emit(operand(0, 2), at(0));
+				emitJumpTo(jumpTarget(chunk, at(1)), at(0));
+				fused = 3;
+			} else if (op(0) == OP_LESS && op(1) == OP_JUMP_IF_FALSE && op(2) == OP_POP) {
+				emit(OP_JUMP_IF_NOT_LESS, at(0));
+				emitJumpTo(jumpTarget(chunk, at(1)), at(0));
+				fused = 3;
+			}
+
+			if (fused > 0) {
+				for (int k = 0; k < fused; k++)
+					newOffset[at(k)] = start;
+				n += fused;
+				continue;
+			}
+
+			// Anything else is copied as is
+			int offset = at(0);
+			int length = instructionLength(chunk, offset);
+			newOffset[offset] = start;
+			for (int i = 0; i < length; i++)
+				emit(code[offset + i], offset + i);
+			if (isJump(code[offset]))
+				jumps.push_back({start + length - 2, jumpTarget(chunk, offset), code[offset] == OP_LOOP});
+			n++;
+		}
+		newOffset[size] = (int) newCode.size();
+
+		for (const PendingJump &jump: jumps) {
+			int end = jump.operand + 2;
+			int target = newOffset[jump.target];
+			int offset = jump.backward ? end - target : target - end;
+			newCode[jump.operand] = (offset >> 8) & 0xff;
+			newCode[jump.operand + 1] = offset & 0xff;
+		}
+
+		chunk.code = std::move(newCode);
+		chunk.lines = std::move(newLines);
+		chunk.columns = std::move(newColumns);
+	}
+} // namespace RyRuntime
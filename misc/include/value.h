@@ -1,172 +1,292 @@
 #pragma once
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
-#include <variant>
+#include <utility>
 #include <vector>
 #include "common.h"
 
 namespace RyRuntime {
-	class RyClosure;
+	struct RyClosure;
 }
 namespace Frontend {
 	class RyClass;
 	class RyBoundMethod;
 } // namespace Frontend
 
-struct RyRange {
-	double start;
-	double end;
+// Every kind of object that lives on the heap
+enum ObjType : uint8_t {
+	OBJ_STRING,
+	OBJ_LIST,
+	OBJ_MAP,
+	OBJ_RANGE,
+	OBJ_FUNCTION,
+	OBJ_NATIVE,
+	OBJ_CLOSURE,
+	OBJ_CLASS,
+	OBJ_INSTANCE,
+	OBJ_BOUND_METHOD,
+	OBJ_UPVALUE
+};
+
+/*
+ * The header shared by every heap object.
+ * Objects must inherit from it first so the header sits at offset 0 of the object.
+ */
+struct RyObject {
+	ObjType type;
+	bool isMarked = false; // Set by the collector when the object is reachable
+	uint32_t allocatedSize = 0; // Bytes accounted to this object
+	RyObject *next = nullptr; // Intrusive list of every object on the heap
 
-	bool operator==(const RyRange &other) const { return start == other.start && end == other.end; }
+	explicit RyObject(ObjType t) : type(t) {}
 };
 
+// Destroys an object, only the collector should call this
+void freeObject(RyObject *object);
+
+// Hands a freshly allocated object to the collector
+void trackObject(RyObject *object, size_t size);
+
+struct RyString;
+
+// Every string object comes from here, short ones are interned (see RyString)
+RyString *newString(std::string chars);
+
+// a + b, appending to a's buffer in place when nothing has been appended to it yet
+RyString *concatenate(const RyString *a, std::string_view b);
+
+// length bytes of s from start (both already in range), long slices share s's buffer instead of copying
+RyString *sliceString(RyString *s, size_t start, size_t length);
+
+// Creates a heap object, every object allocation goes through here
+template<typename T, typename... Args>
+T *allocateObject(Args &&...args) {
+	T *object = new T(std::forward<Args>(args)...);
+	size_t size = sizeof(T);
+	if constexpr (requires { object->payload; })
+		size += object->payload;
+	trackObject(object, size);
+	return object;
+}
+
+struct RyList;
+struct RyMap;
+struct RyRange;
 struct RyValue;
 
 struct RyValueHasher {
 	size_t operator()(const RyValue &v) const;
 };
 
-
+/*
+ * A NaN-boxed value: 8 bytes that hold a double, an integer, a singleton (null/true/false)
+ * or a pointer to a heap object.
+ * Any double that is not a quiet NaN is stored as is, everything else is tucked
+ * into the unused bits of a quiet NaN. Objects also have the sign bit set.
+ * Integers set INT_BIT and keep a 48-bit two's complement number in the low bits. They are
+ * just numbers that happen to be whole: isNumber() and asNumber() accept both kinds, equal
+ * integers and doubles compare and hash the same, and integer arithmetic that leaves the
+ * 48-bit range carries on as a double, which is still exact up to 2^53.
+ * Values are plain bits, the collector owns the objects they point to.
+ */
 struct RyValue {
-	using List = std::shared_ptr<std::vector<RyValue>>;
-	using Map = std::shared_ptr<std::unordered_map<RyValue, RyValue, RyValueHasher>>;
-	using Func = std::shared_ptr<Frontend::RyFunction>;
-	using Instance = std::shared_ptr<Frontend::RyInstance>;
-	using Native = std::shared_ptr<Frontend::RyNative>;
-	using Closure = std::shared_ptr<RyRuntime::RyClosure>;
-	using Class = std::shared_ptr<Frontend::RyClass>;
-	using BoundMethod = std::shared_ptr<Frontend::RyBoundMethod>;
-
-	using Variant = std::variant<std::monostate, Native, Func, Closure, double, bool, std::string, List, RyRange, Map,
-															 Instance, Class, BoundMethod>;
-
-	Variant val;
-
-	RyValue() : val(std::monostate{}) {}
-	RyValue(double d) : val(d) {}
-	RyValue(bool b) : val(b) {}
-	RyValue(std::string s) : val(s) {}
-	RyValue(const char *s) : val(std::string(s)) {}
-	RyValue(List l) : val(l) {}
-	RyValue(Map m) : val(m) {}
-	RyValue(Func f) : val(f) {}
-	RyValue(Closure c) : val(c) {}
-	RyValue(Instance i) : val(i) {}
-	RyValue(std::nullptr_t) : val(std::monostate{}) {}
-	RyValue(Native n) : val(n) {}
-	RyValue(RyRange r) : val(r) {}
-	RyValue(Class c) : val(c) {}
-	RyValue(BoundMethod b) : val(b) {}
-
-
-	bool isNil() const { return std::holds_alternative<std::monostate>(val); }
-	bool isNumber() const { return std::holds_alternative<double>(val); }
-	bool isBool() const { return std::holds_alternative<bool>(val); }
-	bool isString() const { return std::holds_alternative<std::string>(val); }
-	bool isList() const { return std::holds_alternative<List>(val); }
-	bool isMap() const { return std::holds_alternative<Map>(val); }
-	bool isFunction() const { return std::holds_alternative<Func>(val); }
-	bool isInstance() const { return std::holds_alternative<Instance>(val); }
-	bool isNative() const { return std::holds_alternative<Native>(val); };
-	bool isClass() const { return std::holds_alternative<Class>(val); }
-	bool isRange() const { return std::holds_alternative<RyRange>(val); }
-	bool isClosure() const { return std::holds_alternative<Closure>(val); }
-	bool isBoundMethod() const { return std::holds_alternative<BoundMethod>(val); }
+	using List = RyList *;
+	using Map = RyMap *;
+	using Func = Frontend::RyFunction *;
+	using Instance = Frontend::RyInstance *;
+	using Native = Frontend::RyNative *;
+	using Closure = RyRuntime::RyClosure *;
+	using Class = Frontend::RyClass *;
+	using BoundMethod = Frontend::RyBoundMethod *;
+
+	static constexpr uint64_t SIGN_BIT = 0x8000000000000000;
+	static constexpr uint64_t QNAN = 0x7ffc000000000000;
+
+	static constexpr uint64_t TAG_NIL = 1;
+	static constexpr uint64_t TAG_FALSE = 2;
+	static constexpr uint64_t TAG_TRUE = 3;
+	static constexpr uint64_t TAG_EMPTY = 4; // An unset global slot, never seen by scripts
+
+	static constexpr uint64_t NIL_VAL = QNAN | TAG_NIL;
+	static constexpr uint64_t FALSE_VAL = QNAN | TAG_FALSE;
+	static constexpr uint64_t TRUE_VAL = QNAN | TAG_TRUE;
+	static constexpr uint64_t EMPTY_VAL = QNAN | TAG_EMPTY;
+
+	static constexpr uint64_t INT_BIT = 0x0002000000000000;
+	static constexpr uint64_t INT_TAG = QNAN | INT_BIT;
+
+	uint64_t bits;
+
+	RyValue() : bits(NIL_VAL) {}
+	RyValue(double d) { std::memcpy(&bits, &d, sizeof(double)); }
+	RyValue(bool b) : bits(b ? TRUE_VAL : FALSE_VAL) {}
+	RyValue(std::string s);
+	RyValue(const char *s);
+	RyValue(List l) : RyValue(reinterpret_cast<RyObject *>(l)) {}
+	RyValue(Map m) : RyValue(reinterpret_cast<RyObject *>(m)) {}
+	RyValue(Func f) : RyValue(reinterpret_cast<RyObject *>(f)) {}
+	RyValue(Closure c) : RyValue(reinterpret_cast<RyObject *>(c)) {}
+	RyValue(Instance i) : RyValue(reinterpret_cast<RyObject *>(i)) {}
+	RyValue(std::nullptr_t) : bits(NIL_VAL) {}
+	RyValue(Native n) : RyValue(reinterpret_cast<RyObject *>(n)) {}
+	RyValue(RyRange *r) : RyValue(reinterpret_cast<RyObject *>(r)) {}
+	RyValue(Class c) : RyValue(reinterpret_cast<RyObject *>(c)) {}
+	RyValue(BoundMethod b) : RyValue(reinterpret_cast<RyObject *>(b)) {}
+	RyValue(RyString *s) : RyValue(reinterpret_cast<RyObject *>(s)) {}
+	RyValue(RyObject *object) : bits(SIGN_BIT | QNAN | (uint64_t) (uintptr_t) object) {}
+
+	static RyValue empty() {
+		RyValue value;
+		value.bits = EMPTY_VAL;
+		return value;
+	}
+
+	// An integer, or a double when i does not fit in 48 bits
+	static RyValue integer(int64_t i) {
+		uint64_t shifted = (uint64_t) i << 16;
+		if ((int64_t) shifted >> 16 != i) [[unlikely]]
+			return RyValue((double) i);
+		RyValue value;
+		value.bits = INT_TAG | shifted >> 16;
+		return value;
+	}
+
+	// a * b, which unlike a sum can overflow an int64_t before integer() sees it
+	static RyValue multiplyInts(int64_t a, int64_t b) {
+		double product = (double) a * (double) b; // Only rounded once it is far out of range
+		if (product < -0x1p47 || product >= 0x1p47) [[unlikely]]
+			return RyValue(product);
+		return integer(a * b);
+	}
+
+	// d as an integer when it is a whole number in range, -0 stays a double so it still prints as one
+	static RyValue number(double d) {
+		if (d >= -0x1p47 && d < 0x1p47) {
+			int64_t i = (int64_t) d;
+			if ((double) i == d && (i != 0 || !std::signbit(d)))
+				return integer(i);
+		}
+		return RyValue(d);
+	}
+
+	bool isObject() const { return (bits & (QNAN | SIGN_BIT)) == (QNAN | SIGN_BIT); }
+	bool isObjType(ObjType type) const { return isObject() && asObject()->type == type; }
+	RyObject *asObject() const { return (RyObject *) (uintptr_t) (bits & ~(SIGN_BIT | QNAN)); }
+
+	bool isNil() const { return bits == NIL_VAL; }
+	bool isEmpty() const { return bits == EMPTY_VAL; }
+	bool isDouble() const { return (bits & QNAN) != QNAN; }
+	bool isInt() const { return bits >> 48 == INT_TAG >> 48; }
+	bool isNumber() const { return isDouble() || isInt(); }
+	bool isBool() const { return (bits | 1) == TRUE_VAL; }
+	bool isString() const { return isObjType(OBJ_STRING); }
+	bool isList() const { return isObjType(OBJ_LIST); }
+	bool isMap() const { return isObjType(OBJ_MAP); }
+	bool isFunction() const { return isObjType(OBJ_FUNCTION); }
+	bool isInstance() const { return isObjType(OBJ_INSTANCE); }
+	bool isNative() const { return isObjType(OBJ_NATIVE); };
+	bool isClass() const { return isObjType(OBJ_CLASS); }
+	bool isRange() const { return isObjType(OBJ_RANGE); }
+	bool isClosure() const { return isObjType(OBJ_CLOSURE); }
+	bool isBoundMethod() const { return isObjType(OBJ_BOUND_METHOD); }
 
 	double asNumber() const {
-		if (const double *b = std::get_if<double>(&val)) {
-			return *b;
+		if (isDouble()) {
+			double d;
+			std::memcpy(&d, &bits, sizeof(double));
+			return d;
 		}
-		std::cerr << "Value is not a number\n";
-		return 0;
+		if (isInt())
+			return (double) asInt();
+		return notANumber();
 	}
+	int64_t asInt() const { return (int64_t) (bits << 16) >> 16; } // Sign-extends the payload, only for isInt()
+	int64_t toInteger() const { return isInt() ? asInt() : (int64_t) asNumber(); } // Truncates a double
 	Closure asClosure() const {
-		if (const Closure *b = std::get_if<Closure>(&val)) {
-			return *b;
+		if (isClosure()) {
+			return reinterpret_cast<Closure>(asObject());
 		}
 		std::cerr << "Value is not a closure\n";
 		return nullptr;
 	}
 	bool asBool() const {
-		if (const bool *b = std::get_if<bool>(&val)) {
-			return *b;
+		if (isBool()) {
+			return bits == TRUE_VAL;
 		}
 		std::cerr << "Value is not a bool\n";
 		return false;
 	}
-	std::string asString() const {
-		if (const std::string *b = std::get_if<std::string>(&val)) {
-			return *b;
-		}
-		std::cerr << "Value is not a string\n";
-		return "";
-	}
+	std::string_view asString() const; // See RyString::view()
+	RyString *asStringObject() const { return reinterpret_cast<RyString *>(asObject()); }
 	List asList() const {
-		if (const List *b = std::get_if<List>(&val)) {
-			return *b;
+		if (isList()) {
+			return reinterpret_cast<List>(asObject());
 		}
 		std::cerr << "Value is not a list\n";
 		return nullptr;
 	}
 	Map asMap() const {
-		if (const Map *b = std::get_if<Map>(&val)) {
-			return *b;
+		if (isMap()) {
+			return reinterpret_cast<Map>(asObject());
 		}
 		std::cerr << "Value is not a map\n";
 		return nullptr;
 	}
 	Func asFunction() const {
-		if (const Func *b = std::get_if<Func>(&val)) {
-			return *b;
+		if (isFunction()) {
+			return reinterpret_cast<Func>(asObject());
 		}
 		std::cerr << "Value is not a function\n";
 		return nullptr;
 	}
 	Instance asInstance() const {
-		if (const Instance *b = std::get_if<Instance>(&val)) {
-			return *b;
+		if (isInstance()) {
+			return reinterpret_cast<Instance>(asObject());
 		}
 		std::cerr << "Value is not an instance\n";
 		return nullptr;
 	}
 	Native asNative() const {
-		if (const Native *b = std::get_if<Native>(&val)) {
-			return *b;
+		if (isNative()) {
+			return reinterpret_cast<Native>(asObject());
 		}
 		std::cerr << "Value is not a native function\n";
 		return nullptr;
 	}
-	RyRange asRange() const {
-		if (const RyRange *b = std::get_if<RyRange>(&val)) {
-			return *b;
+	RyRange *asRange() const {
+		if (isRange()) {
+			return reinterpret_cast<RyRange *>(asObject());
 		}
 		std::cerr << "Value is not a range\n";
-		return {};
+		return nullptr;
 	}
 	Class asClass() const {
-		if (const Class *b = std::get_if<Class>(&val)) {
-			return *b;
+		if (isClass()) {
+			return reinterpret_cast<Class>(asObject());
 		}
 		std::cerr << "Value is not a class\n";
 		return nullptr;
 	}
 	BoundMethod asBoundMethod() const {
-		if (const BoundMethod *b = std::get_if<BoundMethod>(&val)) {
-			return *b;
+		if (isBoundMethod()) {
+			return reinterpret_cast<BoundMethod>(asObject());
 		}
 		std::cerr << "Value is not a bound method" << std::endl;
 		return nullptr;
 	}
 
 
-	bool operator==(const RyValue &other) const { return val == other.val; }
+	bool operator==(const RyValue &other) const;
 
-	bool operator!=(const RyValue &other) const { return val != other.val; }
+	bool operator!=(const RyValue &other) const { return !(*this == other); }
 
 	std::string to_string() const;
 
@@ -180,5 +300,90 @@ struct RyValue {
 	RyValue operator>(const RyValue &other) const;
 	RyValue operator<(const RyValue &other) const;
 	RyValue operator>=(const RyValue &other) const;
+
+private:
+	// The error path of asNumber(), out of line so the number checks stay small enough to inline
+	static double notANumber();
+};
+
+// --- Heap objects that only hold values ---
+
+/*
+ * An immutable string: length bytes at offset in a buffer.
+ * Strings of up to INTERN_LIMIT characters (identifiers, property names, most map keys)
+ * are interned: there is one object per content, so they are equal exactly when they are
+ * the same object. Longer ones, mostly built by concatenation, skip the table because hashing
+ * each of them up front would cost as much as building it; they hash on first use.
+ * Whether a string is interned only depends on its length, so an interned string never
+ * equals one that is not.
+ *
+ * A string that is not interned shares its buffer with the strings built by appending to it.
+ * While it still ends where the buffer ends, a + b appends b to the buffer and the result is
+ * just a longer view of it. The bytes past its end are invisible to every older string, so
+ * all of them still read as immutable, and building a string piece by piece is amortized O(1)
+ * per piece instead of a copy of everything so far.
+ * Slices longer than INTERN_LIMIT are views into the same buffer too, so indexing and splitting
+ * a large file's contents copies nothing but the short pieces (which keep the buffer alive).
+ */
+struct RyString : RyObject {
+	static constexpr size_t INTERN_LIMIT = 64;
+
+	const std::shared_ptr<std::string> buffer;
+	const size_t offset;
+	const size_t length;
+	const bool interned;
+	const size_t payload; // Bytes this string added to the buffer, for the collector
+
+	// Interned, with its precomputed hash
+	RyString(std::string s, size_t h) :
+			RyObject(OBJ_STRING), buffer(std::make_shared<std::string>(std::move(s))), offset(0),
+			length(buffer->size()), interned(true), payload(length), hash(h), hashed(true) {}
+	explicit RyString(std::string s) :
+			RyObject(OBJ_STRING), buffer(std::make_shared<std::string>(std::move(s))), offset(0),
+			length(buffer->size()), interned(false), payload(length) {}
+	RyString(std::shared_ptr<std::string> b, size_t o, size_t l, size_t added) :
+			RyObject(OBJ_STRING), buffer(std::move(b)), offset(o), length(l), interned(false), payload(added) {}
+
+	// Only valid until the buffer is appended to, do not hold on to it across allocations
+	std::string_view view() const { return {buffer->data() + offset, length}; }
+	bool endsBuffer() const { return offset + length == buffer->size(); }
+
+	size_t hashCode() const {
+		if (!hashed) {
+			hash = std::hash<std::string_view>{}(view());
+			hashed = true;
+		}
+		return hash;
+	}
+
+private:
+	mutable size_t hash = 0;
+	mutable bool hashed = false;
+};
+
+struct RyList : RyObject, std::vector<RyValue> {
+	RyList() : RyObject(OBJ_LIST) {}
+	explicit RyList(const std::vector<RyValue> &items) : RyObject(OBJ_LIST), std::vector<RyValue>(items) {}
+};
+
+struct RyMap : RyObject, std::unordered_map<RyValue, RyValue, RyValueHasher> {
+	RyMap() : RyObject(OBJ_MAP) {}
+};
+
+struct RyRange : RyObject {
+	double start;
+	double end;
+	bool integers; // start is an integer, so is every value a loop over the range visits
+
+	RyRange(double s, double e) : RyObject(OBJ_RANGE), start(s), end(e), integers(RyValue::number(s).isInt()) {}
 };
-typedef RyValue (*NativeFn)(int argCount, RyValue *args, std::map<std::string, RyValue> &globals);
\ No newline at end of file
+
+inline std::string_view RyValue::asString() const {
+	if (isString()) {
+		return asStringObject()->view();
+	}
+	std::cerr << "Value is not a string\n";
+	return {};
+}
+
+typedef RyValue (*NativeFn)(int argCount, RyValue *args, std::vector<RyValue> &globals);
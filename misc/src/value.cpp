@@ -1,5 +1,70 @@
 #include "value.h"
 #include "class.h"
+#include "func.h"
+
+RyValue::RyValue(std::string s) : RyValue(newString(std::move(s))) {}
+RyValue::RyValue(const char *s) : RyValue(newString(std::string(s))) {}
+
+void freeObject(RyObject *object) {
+	switch (object->type) {
+		case OBJ_STRING:
+			delete static_cast<RyString *>(object);
+			break;
+		case OBJ_LIST:
+			delete static_cast<RyList *>(object);
+			break;
+		case OBJ_MAP:
+			delete static_cast<RyMap *>(object);
+			break;
+		case OBJ_RANGE:
+			delete static_cast<RyRange *>(object);
+			break;
+		case OBJ_FUNCTION:
+			delete static_cast<Frontend::RyFunction *>(object);
+			break;
+		case OBJ_NATIVE:
+			delete static_cast<Frontend::RyNative *>(object);
+			break;
+		case OBJ_CLOSURE:
+			delete static_cast<RyRuntime::RyClosure *>(object);
+			break;
+		case OBJ_CLASS:
+			delete static_cast<Frontend::RyClass *>(object);
+			break;
+		case OBJ_INSTANCE:
+			delete static_cast<Frontend::RyInstance *>(object);
+			break;
+		case OBJ_BOUND_METHOD:
+			delete static_cast<Frontend::RyBoundMethod *>(object);
+			break;
+		case OBJ_UPVALUE:
+			delete static_cast<RyRuntime::RyUpValue *>(object);
+			break;
+	}
+}
+
+double RyValue::notANumber() {
+	std::cerr << "Value is not a number\n";
+	return 0;
+}
+
+bool RyValue::operator==(const RyValue &other) const {
+	if (isInt() && other.isInt())
+		return bits == other.bits;
+	if (isNumber() && other.isNumber())
+		return asNumber() == other.asNumber();
+	if (bits == other.bits)
+		return true;
+	if (isString() && other.isString()) {
+		RyString *a = asStringObject();
+		RyString *b = other.asStringObject();
+		// Distinct objects can only match when neither is interned
+		return !a->interned && !b->interned && a->view() == b->view();
+	}
+	if (isRange() && other.isRange())
+		return asRange()->start == other.asRange()->start && asRange()->end == other.asRange()->end;
+	return false;
+}
 
 RyValue RyValue::operator!() const {
 	if (isBool()) {
@@ -9,6 +74,8 @@ RyValue RyValue::operator!() const {
 }
 
 RyValue RyValue::operator>(const RyValue &other) const {
+	if (isInt() && other.isInt())
+		return RyValue(asInt() > other.asInt());
 	if (isNumber() && other.isNumber()) {
 		return RyValue(asNumber() > other.asNumber());
 	}
@@ -16,6 +83,8 @@ RyValue RyValue::operator>(const RyValue &other) const {
 }
 
 RyValue RyValue::operator<(const RyValue &other) const {
+	if (isInt() && other.isInt())
+		return RyValue(asInt() < other.asInt());
 	if (isNumber() && other.isNumber()) {
 		return RyValue(asNumber() < other.asNumber());
 	}
@@ -23,6 +92,8 @@ RyValue RyValue::operator<(const RyValue &other) const {
 }
 
 RyValue RyValue::operator>=(const RyValue &other) const {
+	if (isInt() && other.isInt())
+		return RyValue(asInt() >= other.asInt());
 	if (isNumber() && other.isNumber()) {
 		return RyValue(asNumber() >= other.asNumber());
 	}
@@ -35,7 +106,7 @@ size_t RyValueHasher::operator()(const RyValue &v) const {
 	if (v.isBool())
 		return std::hash<bool>{}(v.asBool());
 	if (v.isString())
-		return std::hash<std::string>{}(v.to_string());
+		return v.asStringObject()->hashCode();
 	if (v.isList())
 		return std::hash<RyValue::List>{}(v.asList());
 	if (v.isMap())
@@ -45,7 +116,9 @@ size_t RyValueHasher::operator()(const RyValue &v) const {
 
 std::string RyValue::to_string() const {
 	if (isString())
-		return asString();
+		return std::string(asString());
+	if (isInt())
+		return std::to_string(asInt());
 	if (isNumber()) {
 		std::string s = std::to_string(asNumber());
 		s.erase(s.find_last_not_of('0') + 1, std::string::npos);
@@ -81,12 +154,12 @@ std::string RyValue::to_string() const {
 		return result;
 	}
 	if (isFunction())
-		return "<function>";
+		return "<closure>"; // A function that captures nothing, scripts cannot tell it from a closure
 	if (isInstance())
 		return asInstance()->klass->name + " instance";
 	if (isRange()) {
-		RyRange r = asRange();
-		return std::to_string((int) r.start) + ".." + std::to_string((int) r.end);
+		RyRange *r = asRange();
+		return std::to_string((int) r->start) + ".." + std::to_string((int) r->end);
 	}
 	if (isNative())
 		return "<native>";
@@ -100,18 +173,24 @@ std::string RyValue::to_string() const {
 }
 
 RyValue RyValue::operator+(const RyValue &other) const {
+	if (isInt() && other.isInt())
+		return integer(asInt() + other.asInt());
 	if (isNumber() && other.isNumber()) {
 		return RyValue(asNumber() + other.asNumber());
 	}
 	return RyValue(to_string() + other.to_string());
 }
 RyValue RyValue::operator-(const RyValue &other) const {
+	if (isInt() && other.isInt())
+		return integer(asInt() - other.asInt());
 	if (isNumber() && other.isNumber()) {
 		return RyValue(asNumber() - other.asNumber());
 	}
 	return RyValue(to_string() + other.to_string());
 }
 RyValue RyValue::operator*(const RyValue &other) const {
+	if (isInt() && other.isInt())
+		return multiplyInts(asInt(), other.asInt());
 	if (isNumber() && other.isNumber()) {
 		return RyValue(asNumber() * other.asNumber());
 	}
@@ -119,17 +198,22 @@ RyValue RyValue::operator*(const RyValue &other) const {
 }
 RyValue RyValue::operator/(const RyValue &other) const {
 	if (isNumber() && other.isNumber()) {
-		return RyValue(asNumber() / other.asNumber());
+		return number(asNumber() / other.asNumber()); // 6 / 3 stays an integer
 	}
 	return RyValue(to_string() + other.to_string());
 }
 RyValue RyValue::operator%(const RyValue &other) const {
+	// Truncating like fmod, which also gives NaN for % 0
+	if (isInt() && other.isInt() && other.asInt() != 0)
+		return integer(asInt() % other.asInt());
 	if (isNumber() && other.isNumber()) {
 		return RyValue(std::fmod(asNumber(), other.asNumber()));
 	}
 	return RyValue(std::nullptr_t{});
 }
 RyValue RyValue::operator-() const {
+	if (isInt() && asInt() != 0)
+		return integer(-asInt());
 	if (isNumber()) {
 		return RyValue(-asNumber());
 	}
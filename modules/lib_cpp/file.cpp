@@ -1,13 +1,13 @@
 #include <fstream>
 #include <string>
-#include <unordered_map>
+#include <vector>
 #include "value.h"
 
-typedef RyValue (*RawNativeFn)(int, RyValue*, std::unordered_map<std::string, RyValue>&);
+typedef RyValue (*RawNativeFn)(int, RyValue*, std::vector<RyValue>&);
 typedef void (*RegisterFn)(const char*, RawNativeFn, int, void*);
 
 // Native function: Read File
-RyValue file_read_raw(int argCount, RyValue* args, std::unordered_map<std::string, RyValue>& globals) {
+RyValue file_read_raw(int argCount, RyValue* args, std::vector<RyValue> &globals) {
     if (argCount < 1 || !args[0].isString()) return RyValue();
 
     std::ifstream file(args[0].to_string());
@@ -18,7 +18,7 @@ RyValue file_read_raw(int argCount, RyValue* args, std::unordered_map<std::strin
 }
 
 // Native function: Write File
-RyValue file_write_raw(int argCount, RyValue* args, std::unordered_map<std::string, RyValue>& globals) {
+RyValue file_write_raw(int argCount, RyValue* args, std::vector<RyValue> &globals) {
     if (argCount < 2 || !args[0].isString() || !args[1].isString()) return RyValue(false);
 
     std::ofstream file(args[0].to_string());
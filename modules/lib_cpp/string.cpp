@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "value.h"
+
+typedef RyValue (*RawNativeFn)(int, RyValue*, std::vector<RyValue>&);
+typedef void (*RegisterFn)(const char*, RawNativeFn, int, void*);
+
+// Checks the argument count and that the first `strings` arguments are strings
+static void expectArgs(const char *name, int argCount, RyValue *args, int count, int strings) {
+	if (argCount != count)
+		throw std::runtime_error(std::string(name) + ": Expected " + std::to_string(count) + " arguments");
+	for (int i = 0; i < strings; i++) {
+		if (!args[i].isString())
+			throw std::runtime_error(std::string(name) + ": Expected string");
+	}
+}
+
+// Position of needle in haystack at or after from, memchr for single characters
+static size_t findFrom(std::string_view haystack, std::string_view needle, size_t from) {
+	if (needle.size() == 1) {
+		if (from >= haystack.size())
+			return std::string_view::npos;
+		const void *hit = std::memchr(haystack.data() + from, needle[0], haystack.size() - from);
+		return hit == nullptr ? std::string_view::npos : (const char *) hit - haystack.data();
+	}
+	return haystack.find(needle, from);
+}
+
+// Native function: substr(s, start, len), clamped to the end of s
+RyValue string_substr(int argCount, RyValue* args, std::vector<RyValue> &) {
+	expectArgs("substr", argCount, args, 3, 1);
+	if (!args[1].isNumber() || !args[2].isNumber())
+		throw std::runtime_error("substr: Expected numbers");
+
+	RyString *s = args[0].asStringObject();
+	double start = args[1].asNumber();
+	double len = args[2].asNumber();
+	if (start < 0)
+		throw std::runtime_error("String index out of bounds.");
+	if (start >= s->length || len <= 0)
+		return RyValue("");
+	size_t from = (size_t) start;
+	return RyValue(sliceString(s, from, std::min((size_t) len, s->length - from)));
+}
+
+// Native function: find(s, needle), -1 when it is not there
+RyValue string_find(int argCount, RyValue* args, std::vector<RyValue> &) {
+	expectArgs("find", argCount, args, 2, 2);
+	size_t at = findFrom(args[0].asString(), args[1].asString(), 0);
+	return RyValue::integer(at == std::string_view::npos ? -1 : (int64_t) at);
+}
+
+// Native function: split(s, separator), an empty separator splits into characters
+// The pieces are slices of s, see sliceString()
+RyValue string_split(int argCount, RyValue* args, std::vector<RyValue> &) {
+	expectArgs("split", argCount, args, 2, 2);
+	RyString *string = args[0].asStringObject();
+	std::string_view s = string->view();
+	std::string_view separator = args[1].asString();
+
+	auto parts = allocateObject<RyList>();
+	if (separator.empty()) {
+		for (size_t i = 0; i < s.size(); i++)
+			parts->push_back(RyValue(sliceString(string, i, 1)));
+		return RyValue(parts);
+	}
+
+	size_t start = 0;
+	while (true) {
+		size_t at = findFrom(s, separator, start);
+		if (at == std::string_view::npos)
+			break;
+		parts->push_back(RyValue(sliceString(string, start, at - start)));
+		start = at + separator.size();
+	}
+	parts->push_back(RyValue(sliceString(string, start, s.size() - start)));
+	return RyValue(parts);
+}
+
+// Native function: join(list, separator)
+RyValue string_join(int argCount, RyValue* args, std::vector<RyValue> &) {
+	if (argCount != 2 || !args[0].isList() || !args[1].isString())
+		throw std::runtime_error("join: Expected a list and a string");
+
+	std::string_view separator = args[1].asString();
+	std::string result;
+	bool first = true;
+	for (const RyValue &item: *args[0].asList()) {
+		if (!first)
+			result.append(separator);
+		first = false;
+		if (item.isString())
+			result.append(item.asString());
+		else
+			result.append(item.to_string());
+	}
+	return RyValue(result);
+}
+
+// Native function: replace(s, from, to), every occurrence
+RyValue string_replace(int argCount, RyValue* args, std::vector<RyValue> &) {
+	expectArgs("replace", argCount, args, 3, 3);
+	std::string_view s = args[0].asString();
+	std::string_view from = args[1].asString();
+	std::string_view to = args[2].asString();
+	if (from.empty())
+		return args[0];
+
+	std::string result;
+	result.reserve(s.size());
+	size_t start = 0;
+	while (true) {
+		size_t at = findFrom(s, from, start);
+		if (at == std::string_view::npos)
+			break;
+		result.append(s.substr(start, at - start));
+		result.append(to);
+		start = at + from.size();
+	}
+	result.append(s.substr(start));
+	return RyValue(result);
+}
+
+// Native function: upper(s), ASCII only
+RyValue string_upper(int argCount, RyValue* args, std::vector<RyValue> &) {
+	expectArgs("upper", argCount, args, 1, 1);
+	std::string result(args[0].asString());
+	for (char &c: result)
+		c = (char) std::toupper((unsigned char) c);
+	return RyValue(result);
+}
+
+// Native function: lower(s), ASCII only
+RyValue string_lower(int argCount, RyValue* args, std::vector<RyValue> &) {
+	expectArgs("lower", argCount, args, 1, 1);
+	std::string result(args[0].asString());
+	for (char &c: result)
+		c = (char) std::tolower((unsigned char) c);
+	return RyValue(result);
+}
+
+// Native function: trim(s), whitespace on both ends
+RyValue string_trim(int argCount, RyValue* args, std::vector<RyValue> &) {
+	expectArgs("trim", argCount, args, 1, 1);
+	std::string_view s = args[0].asString();
+	size_t start = 0;
+	size_t end = s.size();
+	while (start < end && std::isspace((unsigned char) s[start]))
+		start++;
+	while (end > start && std::isspace((unsigned char) s[end - 1]))
+		end--;
+	return RyValue(sliceString(args[0].asStringObject(), start, end - start));
+}
+
+// Native function: starts_with(s, prefix)
+RyValue string_starts_with(int argCount, RyValue* args, std::vector<RyValue> &) {
+	expectArgs("starts_with", argCount, args, 2, 2);
+	return RyValue(args[0].asString().starts_with(args[1].asString()));
+}
+
+// Native function: ends_with(s, suffix)
+RyValue string_ends_with(int argCount, RyValue* args, std::vector<RyValue> &) {
+	expectArgs("ends_with", argCount, args, 2, 2);
+	return RyValue(args[0].asString().ends_with(args[1].asString()));
+}
+
+// The Entry Point
+extern "C" void init_ry_module(RegisterFn register_fn, void *target) {
+	register_fn("substr", string_substr, 3, target);
+	register_fn("find", string_find, 2, target);
+	register_fn("split", string_split, 2, target);
+	register_fn("join", string_join, 2, target);
+	register_fn("replace", string_replace, 3, target);
+	register_fn("upper", string_upper, 1, target);
+	register_fn("lower", string_lower, 1, target);
+	register_fn("trim", string_trim, 1, target);
+	register_fn("starts_with", string_starts_with, 2, target);
+	register_fn("ends_with", string_ends_with, 2, target);
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include "globals.h"
 #include "native_io.hpp"
 #include "native_list.hpp"
 #include "native_sys.hpp"
@@ -6,11 +7,14 @@
 #include "native_use.hpp"
 
 namespace RyRuntime {
-	inline std::vector<std::string> getNativeNames() { return {"out", "input", "clock", "clear", "exit", "type", "use"}; }
-	inline void registerNatives(std::map<std::string, RyValue> &globals) {
+	inline std::vector<std::string> getNativeNames() { return {"out", "input", "clock", "clear", "exit", "type", "use", "gc"}; }
+	inline void registerNatives(std::vector<RyValue> &globals) {
 		auto define = [&](std::string name, NativeFn fn, int arity) {
-			auto native = std::make_shared<Frontend::RyNative>(fn, name, arity);
-			globals[name] = RyValue(native);
+			auto native = allocateObject<Frontend::RyNative>(fn, name, arity);
+			int slot = globalNames().slotFor(name);
+			if (slot >= (int) globals.size())
+				globals.resize(slot + 1, RyValue::empty());
+			globals[slot] = RyValue(native);
 		};
 
 		define("out", ry_out, 1);
@@ -20,5 +24,6 @@ namespace RyRuntime {
 		define("exit", ry_exit, 1);
 		define("type", ry_type, 1);
 		define("use", ry_use, 1);
+		define("gc", ry_gc, 0);
 	}
 } // namespace RyRuntime
@@ -22,7 +22,7 @@ namespace RyRuntime {
 
 	// Native 'out(...args)'
 	// Takes variadic arguments and prints them with spaces in between
-	inline RyValue ry_out(int argCount, RyValue *args, std::map<std::string, RyValue>& globals) {
+	inline RyValue ry_out(int argCount, RyValue *args, std::vector<RyValue> &globals) {
 		for (int i = 0; i < argCount; i++) {
 			std::cout << args[i].to_string();
 			if (i < argCount - 1)
@@ -33,7 +33,7 @@ namespace RyRuntime {
 	}
 
 	// Native 'input(prompt)'
-	inline RyValue ry_input(int argCount, RyValue *args, std::map<std::string, RyValue>& globals) {
+	inline RyValue ry_input(int argCount, RyValue *args, std::vector<RyValue> &globals) {
 		if (argCount > 0) {
 			std::cout << args[0].to_string();
 			std::cout.flush();
@@ -48,7 +48,7 @@ namespace RyRuntime {
 			size_t idx = 0;
 			double val = std::stod(line, &idx);
 			if (idx == line.size())
-				return RyValue(val);
+				return RyValue::number(val);
 		} catch (...) {
 		}
 
@@ -1,9 +1,10 @@
 #include <iostream>
 #include "colors.h"
+#include "memory.h"
 #include "value.h"
 
 namespace RyRuntime {
-	inline RyValue ry_exit(int argCount, RyValue *args, std::map<std::string, RyValue> &globals) {
+	inline RyValue ry_exit(int argCount, RyValue *args, std::vector<RyValue> &globals) {
 		int exitCode = args->asNumber();
 		std::cout << RyColor::BOLD << RyColor::YELLOW << "[Ry] Exited Successfully with exit code: " << exitCode
 							<< RyColor::RESET << std::endl;
@@ -12,12 +13,21 @@ namespace RyRuntime {
 
 
 	// Native 'clock()' - Useful for benchmarking Ry
-	inline RyValue ry_clock(int argCount, RyValue *args, std::map<std::string, RyValue> &globals) {
+	inline RyValue ry_clock(int argCount, RyValue *args, std::vector<RyValue> &globals) {
 		return RyValue((double) clock() / CLOCKS_PER_SEC);
 	}
 
+	// Native 'gc()' - Forces a full collection and returns the bytes still in use
+	// An optional argument sets how much the heap may grow before the next automatic collection
+	inline RyValue ry_gc(int argCount, RyValue *args, std::vector<RyValue> &globals) {
+		if (argCount > 0 && args[0].isNumber() && args[0].asNumber() > 1)
+			heap().growthFactor = args[0].asNumber();
+		heap().collect();
+		return RyValue::integer(heap().bytesAllocated);
+	}
+
 	// Native 'clear()' - Useful for clearing output
-	inline RyValue ry_clear(int argCount, RyValue *args, std::map<std::string, RyValue> &globals) {
+	inline RyValue ry_clear(int argCount, RyValue *args, std::vector<RyValue> &globals) {
 #ifdef _WIN32
 		// Windows specific clear
 		auto _ system("cls");
@@ -2,7 +2,7 @@
 #include "value.h"
 
 namespace RyRuntime {
-	inline RyValue ry_type(int argCount, RyValue *args, std::map<std::string, RyValue>& globals) {
+	inline RyValue ry_type(int argCount, RyValue *args, std::vector<RyValue> &globals) {
 		RyValue value = args[0];
 
 		if (value.isNumber())
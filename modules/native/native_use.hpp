@@ -10,7 +10,7 @@ namespace RyRuntime {
     
     typedef void (*InitFnType)(RegisterFn, void*);
 
-    inline RyValue ry_use(int argCount, RyValue *args, std::map<std::string, RyValue> &globals) {
+    inline RyValue ry_use(int argCount, RyValue *args, std::vector<RyValue> &globals) {
         if (argCount < 1 || !args[0].isString()) return RyValue();
 
         std::string libName = args[0].to_string();
@@ -22,14 +22,14 @@ namespace RyRuntime {
         }
 
         // Create the Map that will be returned to the Ry script
-        auto moduleMap = std::make_shared<std::unordered_map<RyValue, RyValue, RyValueHasher>>();
+        auto moduleMap = allocateObject<RyMap>();
 
         // The Bridge: This lambda must NOT capture [&] to be used as a raw function pointer
         auto register_callback = [](const char* name, NativeFn fn, int arity, void* mapPtr) {
-            auto* map = static_cast<std::unordered_map<RyValue, RyValue, RyValueHasher>*>(mapPtr);
+            auto* map = static_cast<RyMap*>(mapPtr);
             
             // Wrap the C++ function into a Ry Native Object
-            auto native = std::make_shared<Frontend::RyNative>(fn, name, arity);
+            auto native = allocateObject<Frontend::RyNative>(fn, name, arity);
             
             // Insert into the Map
             (*map)[RyValue(name)] = RyValue(native);
@@ -39,7 +39,7 @@ namespace RyRuntime {
         InitFnType init_module = (InitFnType)Backend::RyLoader::getSymbol(handle, "init_ry_module");
 
         if (init_module) {
-            init_module(register_callback, moduleMap.get());
+            init_module(register_callback, moduleMap);
         } else {
             std::cerr << "Ry Symbol Error: " << Backend::RyLoader::getError() << std::endl;
         }
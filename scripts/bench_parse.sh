@@ -0,0 +1,56 @@
+#!/bin/bash
+
+# Front end throughput: lexes, parses and compiles a generated Ry file with `ry compile`.
+# Usage: ./scripts/bench_parse.sh [path/to/ry] [lines] [runs]
+
+RY=${1:-build/ry}
+LINES=${2:-100000}
+RUNS=${3:-5}
+
+# --- Color Definitions ---
+CYAN='\033[36m'
+BOLD='\033[1m'
+RESET='\033[0m'
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+SOURCE="$WORK/bench.ry"
+
+# Functions nested inside functions, so no chunk goes over 256 constants or locals
+awk -v lines="$LINES" 'BEGIN {
+    body = 150; inner = 134
+    n = 0; outer = 0
+    while (n < lines) {
+        printf "func outer%d() {\n", outer++; n++
+        for (i = 0; i < inner && n < lines; i++) {
+            printf "    func inner%d(a, b) {\n", i; n++
+            printf "        data v0 = a\n"; n++
+            for (j = 1; j < body && n < lines; j++) {
+                k = j % 5
+                if (k == 0) printf "        data v%d = a * b + v%d - (b / 2) # arithmetic\n", j, j - 1
+                if (k == 1) printf "        data v%d = [v%d, a, b]\n", j, j - 1
+                if (k == 2) printf "        data v%d = \"item \" + b\n", j
+                if (k == 3) printf "        data v%d = max(a, v%d) and b or a\n", j, j - 2
+                if (k == 4) printf "        data v%d = {\"key\": a}\n", j
+                n++
+            }
+            printf "        return v0\n    }\n"; n += 2
+        }
+        printf "    return 0\n}\n"; n += 2
+    }
+}' > "$SOURCE"
+
+echo -e "${CYAN}${BOLD}Compiling $(wc -l < "$SOURCE") lines ($(du -h "$SOURCE" | cut -f1)), best of $RUNS${RESET}"
+
+best=""
+for ((run = 0; run < RUNS; run++)); do
+    start=$(date +%s%N)
+    "$RY" compile "$SOURCE" -o "$WORK/bench.ryc" > /dev/null || exit 1
+    elapsed=$(( ($(date +%s%N) - start) / 1000 ))
+    if [ -z "$best" ] || [ "$elapsed" -lt "$best" ]; then
+        best=$elapsed
+    fi
+done
+
+lines=$(wc -l < "$SOURCE")
+echo "$(awk -v us="$best" -v l="$lines" 'BEGIN { printf "%.1f ms, %.0f lines/s", us / 1000, l / (us / 1e6) }')"
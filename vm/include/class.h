@@ -1,5 +1,7 @@
 #include <memory>
 #include "unordered_map"
+#include "globals.h"
+#include "shape.h"
 #include "vm.h"
 
 namespace Frontend {
@@ -8,25 +10,41 @@ namespace Frontend {
 		bool hasSuperclass = false;
 	};
 
-	class RyClass {
+	class RyClass : public RyObject {
 	public:
 		std::string name;
-		std::shared_ptr<RyClass> superclass = nullptr;
-		std::unordered_map<std::string, std::shared_ptr<RyRuntime::RyClosure>> methods;
-		RyClass(std::string n) : name(n) {}
+		RyClass *superclass = nullptr;
+		// Indexed by method symbol (see methodNames()), nullptr where the class has no such method.
+		// Inherited methods are copied down by OP_INHERIT before the class body overrides them.
+		std::vector<RyRuntime::RyClosure *> vtable;
+		RyRuntime::Shape rootShape; // The shape of a new instance, before any field is set
+		RyClass(std::string n) : RyObject(OBJ_CLASS), name(n) {}
+
+		RyRuntime::RyClosure *findMethod(int symbol) const {
+			return symbol >= 0 && symbol < (int) vtable.size() ? vtable[symbol] : nullptr;
+		}
+		RyRuntime::RyClosure *findMethod(const std::string &name) const {
+			return findMethod(RyRuntime::methodNames().find(name));
+		}
+		void setMethod(int symbol, RyRuntime::RyClosure *method) {
+			if (symbol >= (int) vtable.size())
+				vtable.resize(symbol + 1, nullptr);
+			vtable[symbol] = method;
+		}
 	};
 
-	class RyInstance {
+	class RyInstance : public RyObject {
 	public:
-		std::shared_ptr<RyClass> klass;
-		std::unordered_map<std::string, RyValue> fields;
-		RyInstance(std::shared_ptr<RyClass> k) : klass(k) {}
+		RyClass *klass;
+		RyRuntime::Shape *shape; // Owned by klass
+		std::vector<RyValue> fields; // Indexed by the slots of shape
+		RyInstance(RyClass *k) : RyObject(OBJ_INSTANCE), klass(k), shape(&k->rootShape) {}
 	};
 
-	class RyBoundMethod {
+	class RyBoundMethod : public RyObject {
 	public:
 		RyValue receiver;
-		std::shared_ptr<RyRuntime::RyClosure> method;
-		RyBoundMethod(RyValue r, std::shared_ptr<RyRuntime::RyClosure> m) : receiver(r), method(m) {}
+		RyRuntime::RyClosure *method;
+		RyBoundMethod(RyValue r, RyRuntime::RyClosure *m) : RyObject(OBJ_BOUND_METHOD), receiver(r), method(m) {}
 	};
 } // namespace Frontend
@@ -15,32 +15,34 @@ namespace Frontend {
 	/*
 	 * Contains the data for functions
 	 */
-	class RyFunction {
+	class RyFunction : public RyObject {
 	public:
 		int arity; // Holds how many parameters a function needs
 		RyRuntime::Chunk chunk; // The data for the function
 		std::string name; // The name of the function
 		int upvalueCount = 0;
+		RyRuntime::RyClosure *closure = nullptr; // Shared by all its closures when it captures nothing, see newClosure()
 
-		RyFunction() : arity(0), name("") {} // Default Constructor for main
+		RyFunction() : RyObject(OBJ_FUNCTION), arity(0), name("") {} // Default Constructor for main
 
 		// Constructor for user made functions
-		RyFunction(RyRuntime::Chunk c, std::string n, int a) : chunk(std::move(c)), name(n), arity(a) {}
+		RyFunction(RyRuntime::Chunk c, std::string n, int a) :
+				RyObject(OBJ_FUNCTION), chunk(std::move(c)), name(n), arity(a) {}
 	}; // class RyFunction
 
 	/*
 	 * Contains the data for native functions
 	 */
-	class RyNative {
+	class RyNative : public RyObject {
 	public:
 		NativeFn function; // Contains the raw function
 		std::string name; // Contains the name
 		int arity; // Constains how much parameters it needs
 
-		RyNative() : name(""), arity(0) {} // Default Constructor
+		RyNative() : RyObject(OBJ_NATIVE), name(""), arity(0) {} // Default Constructor
 
 		// Constructor for building native functions
-		RyNative(NativeFn fn, std::string n, int a) : function(fn), name(n), arity(a) {}
-		RyNative(NativeFn f, int a) : function(f), arity(a) {}
+		RyNative(NativeFn fn, std::string n, int a) : RyObject(OBJ_NATIVE), function(fn), name(n), arity(a) {}
+		RyNative(NativeFn f, int a) : RyObject(OBJ_NATIVE), function(f), arity(a) {}
 	}; // class RyNative
 } // namespace Frontend
@@ -0,0 +1,53 @@
+/**
+	File: memory.h
+	Description: The mark-sweep garbage collector that owns every RyObject
+*/
+
+#pragma once // Include guard
+#include <cstddef>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "value.h"
+
+namespace RyRuntime {
+	class VM;
+
+	/*
+	 * Every object allocated through allocateObject() ends up here.
+	 * The VM that owns the heap supplies the roots and decides when it is safe to collect,
+	 * so objects that are still being built by the compiler or a native are never swept.
+	 */
+	class Heap {
+	public:
+		~Heap(); // Frees whatever is left when the process ends
+
+		static constexpr size_t MIN_HEAP = 1024 * 1024; // Never collect before this many bytes
+
+		VM *owner = nullptr; // The VM that supplies the roots
+		size_t bytesAllocated = 0; // Bytes currently accounted to live objects
+		size_t nextGC = MIN_HEAP; // Collect once bytesAllocated crosses this
+		double growthFactor = 2.0; // How much the heap may grow after a collection
+
+		void track(RyObject *object, size_t size);
+		RyString *intern(std::string chars); // The one string object with these characters, see newString()
+		bool shouldCollect() const { return bytesAllocated > nextGC; }
+		size_t collect(); // Runs a full collection, returns the number of bytes freed
+
+		void markValue(RyValue value);
+		void markObject(RyObject *object);
+
+	private:
+		RyObject *objects = nullptr; // Every object, newest first
+		std::vector<RyObject *> grayStack; // Marked objects whose references still need marking
+		std::unordered_map<std::string_view, RyString *> strings; // Weak, keyed by views of each string's own buffer
+
+		void traceReferences();
+		void removeUnmarkedStrings(); // Before the sweep, so the table never points at a freed string
+		void blacken(RyObject *object);
+		size_t sweep();
+	};
+
+	// The heap every object is allocated on
+	Heap &heap();
+} // namespace RyRuntime
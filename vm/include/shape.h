@@ -0,0 +1,36 @@
+#ifndef ry_shape_h
+#define ry_shape_h
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace RyRuntime {
+
+	/*
+	 * A hidden class: which slot each field of an instance is stored in.
+	 * Instances of a class that got the same fields in the same order share a shape,
+	 * so a property site only has to compare shapes to know where a field lives.
+	 * Every class owns the tree of shapes grown from its root and frees it along with itself.
+	 */
+	class Shape {
+	public:
+		// Unique for the whole run, inline caches compare this instead of the pointer
+		// because a freed class can hand its shapes' addresses to a new one
+		const uint32_t id;
+
+		Shape();
+		int find(const std::string &name) const; // Returns -1 if the field is not part of this shape
+		int fieldCount() const { return (int) slots.size(); }
+		Shape *withField(const std::string &name); // The shape after adding a field, created the first time
+
+	private:
+		Shape(const Shape &parent, const std::string &name);
+
+		std::unordered_map<std::string, int> slots; // Name -> slot, for every field up to this shape
+		std::unordered_map<std::string, std::unique_ptr<Shape>> transitions; // One per field added next
+	};
+} // namespace RyRuntime
+
+#endif
@@ -5,31 +5,50 @@
 */
 
 #pragma once // Include guard
+#include <algorithm>
 #include <memory>
 #include "chunk.h" // For the byte chunk
 #include "func.h"
+#include "memory.h"
 #include "map" // For map
 #include "unordered_map" // For unordered map
 
 namespace RyRuntime {
-	struct RyUpValue {
+	// A captured variable, shared by every closure that captured it
+	struct RyUpValue final : RyObject {
 		RyValue *location; // Points to the stack slot
 		RyValue closed; // Stores the value when the stack frame dies
-		std::shared_ptr<RyUpValue> next; // Useful for the VM to track open upvalues
+		RyUpValue *next = nullptr; // Useful for the VM to track open upvalues
+
+		explicit RyUpValue(RyValue *slot) : RyObject(OBJ_UPVALUE), location(slot) {}
+
+		// Every cell is the same size and captures are frequent, so they are recycled through a free list.
+		// final, so nothing bigger can come through operator new
+		static void *operator new(size_t size);
+		static void operator delete(void *cell);
 	};
-	struct RyClosure {
-		std::shared_ptr<Frontend::RyFunction> function;
-		// The "Backpack" - pointers to the captured variables
-		std::vector<std::shared_ptr<RyUpValue>> upvalues;
-
-		RyClosure(std::shared_ptr<Frontend::RyFunction> func) : function(func) {
-			// Initialize the backpack based on what the compiler told us
-			upvalues.resize(func->upvalueCount, nullptr);
+	struct RyClosure : RyObject {
+		Frontend::RyFunction *function;
+
+		// The "Backpack" - pointers to the captured variables, stored right after the closure in the same block
+		RyUpValue **upvalues() { return reinterpret_cast<RyUpValue **>(this + 1); }
+
+		// Only newClosure() allocates them
+		static void operator delete(void *block) { ::operator delete(block); }
+
+	private:
+		friend RyClosure *newClosure(Frontend::RyFunction *function);
+		explicit RyClosure(Frontend::RyFunction *func) : RyObject(OBJ_CLOSURE), function(func) {
+			std::fill(upvalues(), upvalues() + func->upvalueCount, nullptr);
 		}
 	};
+
+	// A closure over function. Functions that capture nothing share one closure, made the first time it is needed
+	RyClosure *newClosure(Frontend::RyFunction *function);
 	// Used for functions
 	struct CallFrame {
-		std::shared_ptr<RyClosure> closure; // The function being run
+		Frontend::RyFunction *function; // The function being run
+		RyClosure *closure; // Its upvalues, nullptr when a function that captures nothing was called bare
 		uint8_t *ip; // The IP inside THIS function
 		RyValue *slots; // Where this function's stack begins
 	};
@@ -49,45 +68,74 @@ namespace RyRuntime {
 	class VM {
 	public:
 		VM(); // Constructor
-		~VM() = default; // Default Constructor
+		~VM(); // Detaches from the heap
 
 		// The main entry point to run a piece of Ry code
-		InterpretResult interpret(std::shared_ptr<Frontend::RyFunction> function);
+		InterpretResult interpret(Frontend::RyFunction *function);
+
+		// Serves imports of path from a precompiled bundle instead of the file system
+		void addBundledModule(const std::string &path, Frontend::RyFunction *function);
+
+		// How deep calls may nest before a "Stack Overflow!" panic, the value stack is allowed to keep up. Set before running
+		void setCallDepthLimit(int maxFrames);
 
 		// Resolver
 		void resolve(Backend::Expr *expr, int depth) { locals[expr] = depth; }
 
+		// Marks everything the VM can still reach, called by the collector
+		void markRoots(Heap &heap);
+
 	private:
 		InterpretResult run(); // Runs ry
-		std::map<std::string, RyValue> globals; // Data outside classes/functions
+		std::vector<RyValue> globals; // Data outside classes/functions, indexed by global slot
 		std::vector<ControlBlock> panicStack; // Stacks caused by a panic
-		std::shared_ptr<RyUpValue> openUpvalues;
-		std::unordered_map<std::string, std::shared_ptr<RyClosure>> moduleCache;
-
-		uint8_t *ip; // Points to the NEXT byte to be executed
-		CallFrame frames[64]; // The "Call Stack"
+		RyUpValue *openUpvalues = nullptr; // Sorted by slot, the topmost first
+		std::unordered_map<std::string, RyClosure *> moduleCache;
+		std::unordered_map<std::string, RyClosure *> bundledModules; // Keyed by the path as the import names it
+
+		// --- The Call Stack ---
+		static const int FRAMES_INITIAL = 64; // Doubled whenever a call needs more
+		static const int FRAMES_MAX = 100000; // Default call depth limit
+		std::vector<CallFrame> frames; // The "Call Stack"
 		int frameCount; // Current depth
-
-		// The bytecode it is currently running
-		Chunk *chunk;
+		int frameCapacity; // Frames usable before growFrames() is needed, at most maxFrames
+		int maxFrames = FRAMES_MAX;
 
 		std::map<Backend::Expr *, int> locals; // Data inside classes/functions
 
 		// --- The Stack ---
-		static const int STACK_MAX = 256; // Maximum stack
-		RyValue stack[STACK_MAX]; // The stack
+		static const int STACK_INITIAL = 256; // Doubled whenever a push needs more
+		static const int STACK_MAX = 1 << 22; // Default limit, in values
+		std::vector<RyValue> stackValues; // Owns the stack, it moves when it grows
+		RyValue *stack; // The stack, stackValues.data()
+		RyValue *stackLimit; // The last slot, left free so an error message always fits
 		RyValue *stackTop; // Points to where the next pushed value will go
-		RyValue peek(int distance); // Returns the stack based on the distance
+		int maxValues = STACK_MAX;
+		RyValue peek(int distance) { return stackTop[-1 - distance]; } // Returns the stack based on the distance
 
 		// Stack helpers
 		void resetStack(); // Reset's the stack
-		void push(RyValue value); // Adds a stack
-		RyValue pop(); // Removes a stack
+		// Both false at their limit. Pointers into what they grow have to be reloaded, growStack() rebases the frames and upvalues
+		bool growStack();
+		bool growFrames();
+		// Defined here so run() always inlines them, whatever its size
+		void push(RyValue value) { *stackTop++ = value; } // Adds a stack
+		RyValue pop() { return *--stackTop; } // Removes a stack
 
 		// Runtime helpers
 		void runtimeError(const char *format, ...); // Calls report() for advance error reporting
 		bool isTruthy(RyValue value);
-		std::shared_ptr<RyUpValue> captureUpvalue(RyValue *local);
+		bool addValues(RyValue a, RyValue b, RyValue &result); // Lists and strings, false after reporting an error
+		bool subtractValues(RyValue a, RyValue b, RyValue &result);
+		bool multiplyValues(RyValue a, RyValue b, RyValue &result);
+		bool lessValues(RyValue a, RyValue b, RyValue &result);
+		// What object.name evaluates to, false if nothing. Instance lookups fill cache, "pop" is left to the caller
+		bool getProperty(RyValue object, RyValue name, PropertyCache &cache, RyValue &result);
+		const PropertyCache::Entry *cacheFieldStore(PropertyCache &cache, Shape *shape, const std::string &name); // On a SET miss
+		RyClosure *loadModule(const std::string &path); // Compiles an import once, nullptr after reporting an error
+		std::string closestGlobal(const std::string &name); // For "Did you mean" suggestions
+		void growGlobals(); // Makes room for every slot the compiler has handed out
+		RyUpValue *captureUpvalue(RyValue *local);
 		void closeUpvalues(RyValue *last);
 	};
 } // namespace RyRuntime
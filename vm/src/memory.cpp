@@ -0,0 +1,241 @@
+#include "memory.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "class.h"
+#include "func.h"
+#include "vm.h"
+
+void trackObject(RyObject *object, size_t size) { RyRuntime::heap().track(object, size); }
+
+RyString *newString(std::string chars) {
+	if (chars.size() <= RyString::INTERN_LIMIT)
+		return RyRuntime::heap().intern(std::move(chars));
+	return allocateObject<RyString>(std::move(chars));
+}
+
+RyString *concatenate(const RyString *a, std::string_view b) {
+	size_t length = a->length + b.size();
+	if (length > RyString::INTERN_LIMIT && !a->interned && a->endsBuffer()) {
+		a->buffer->append(b); // Safe even when b views the same buffer
+		return allocateObject<RyString>(a->buffer, a->offset, length, b.size());
+	}
+
+	std::string chars;
+	chars.reserve(length);
+	chars.append(a->view());
+	chars.append(b);
+	return newString(std::move(chars));
+}
+
+RyString *sliceString(RyString *s, size_t start, size_t length) {
+	if (start == 0 && length == s->length)
+		return s;
+	// Short slices keep the interning rule, see RyString
+	if (length <= RyString::INTERN_LIMIT)
+		return RyRuntime::heap().intern(std::string(s->view().substr(start, length)));
+	return allocateObject<RyString>(s->buffer, s->offset + start, length, 0);
+}
+
+namespace RyRuntime {
+	namespace {
+		// Upvalue cells are carved out of blocks and never handed back, a freed cell goes on the free list
+		union UpvalueCell {
+			UpvalueCell *nextFree;
+			alignas(RyUpValue) std::byte storage[sizeof(RyUpValue)];
+		};
+		constexpr size_t CELLS_PER_BLOCK = 256;
+		std::vector<std::unique_ptr<UpvalueCell[]>> cellBlocks;
+		UpvalueCell *freeCells = nullptr;
+		static_assert(sizeof(UpvalueCell) == sizeof(RyUpValue), "a cell holds exactly one upvalue");
+	} // namespace
+
+	void *RyUpValue::operator new(size_t) { // Always sizeof(RyUpValue), the class is final
+		if (freeCells == nullptr) {
+			cellBlocks.push_back(std::make_unique<UpvalueCell[]>(CELLS_PER_BLOCK));
+			UpvalueCell *block = cellBlocks.back().get();
+			for (size_t i = 0; i < CELLS_PER_BLOCK; i++) {
+				block[i].nextFree = freeCells;
+				freeCells = &block[i];
+			}
+		}
+		UpvalueCell *cell = freeCells;
+		freeCells = cell->nextFree;
+		return cell;
+	}
+
+	void RyUpValue::operator delete(void *cell) {
+		auto freed = static_cast<UpvalueCell *>(cell);
+		freed->nextFree = freeCells;
+		freeCells = freed;
+	}
+
+	RyClosure *newClosure(Frontend::RyFunction *function) {
+		if (function->upvalueCount == 0 && function->closure != nullptr)
+			return function->closure;
+
+		size_t size = sizeof(RyClosure) + function->upvalueCount * sizeof(RyUpValue *);
+		RyClosure *closure = new (::operator new(size)) RyClosure(function);
+		trackObject(closure, size);
+		if (function->upvalueCount == 0)
+			function->closure = closure;
+		return closure;
+	}
+
+	Heap &heap() {
+		static Heap instance;
+		return instance;
+	}
+
+	Heap::~Heap() {
+		RyObject *object = objects;
+		while (object != nullptr) {
+			RyObject *next = object->next;
+			freeObject(object);
+			object = next;
+		}
+	}
+
+	void Heap::track(RyObject *object, size_t size) {
+		object->allocatedSize = (uint32_t) size;
+		object->next = objects;
+		objects = object;
+		bytesAllocated += size;
+	}
+
+	RyString *Heap::intern(std::string chars) {
+		auto it = strings.find(chars);
+		if (it != strings.end())
+			return it->second;
+
+		size_t hash = std::hash<std::string_view>{}(chars);
+		RyString *string = allocateObject<RyString>(std::move(chars), hash);
+		strings.emplace(string->view(), string);
+		return string;
+	}
+
+	void Heap::markValue(RyValue value) {
+		if (value.isObject())
+			markObject(value.asObject());
+	}
+
+	void Heap::markObject(RyObject *object) {
+		if (object == nullptr || object->isMarked)
+			return;
+		object->isMarked = true;
+		grayStack.push_back(object);
+	}
+
+	size_t Heap::collect() {
+		// Without a VM there is no way to know what is still reachable
+		if (owner == nullptr)
+			return 0;
+
+		owner->markRoots(*this);
+		traceReferences();
+		removeUnmarkedStrings();
+		size_t freed = sweep();
+
+		nextGC = std::max((size_t) (bytesAllocated * growthFactor), MIN_HEAP);
+		return freed;
+	}
+
+	void Heap::traceReferences() {
+		while (!grayStack.empty()) {
+			RyObject *object = grayStack.back();
+			grayStack.pop_back();
+			blacken(object);
+		}
+	}
+
+	// Marks everything an object references
+	void Heap::blacken(RyObject *object) {
+		switch (object->type) {
+			case OBJ_STRING:
+			case OBJ_RANGE:
+			case OBJ_NATIVE:
+				break;
+			case OBJ_LIST: {
+				for (const RyValue &item: *static_cast<RyList *>(object))
+					markValue(item);
+				break;
+			}
+			case OBJ_MAP: {
+				for (const auto &[key, value]: *static_cast<RyMap *>(object)) {
+					markValue(key);
+					markValue(value);
+				}
+				break;
+			}
+			case OBJ_FUNCTION: {
+				auto function = static_cast<Frontend::RyFunction *>(object);
+				for (const RyValue &constant: function->chunk.constants)
+					markValue(constant);
+				markObject(function->closure);
+				break;
+			}
+			case OBJ_CLOSURE: {
+				auto closure = static_cast<RyClosure *>(object);
+				markObject(closure->function);
+				for (int i = 0; i < closure->function->upvalueCount; i++)
+					markObject(closure->upvalues()[i]);
+				break;
+			}
+			case OBJ_UPVALUE: {
+				// Open or closed, location points at the captured value
+				markValue(*static_cast<RyUpValue *>(object)->location);
+				break;
+			}
+			case OBJ_CLASS: {
+				auto klass = static_cast<Frontend::RyClass *>(object);
+				markObject(klass->superclass);
+				for (RyClosure *method: klass->vtable)
+					markObject(method);
+				break;
+			}
+			case OBJ_INSTANCE: {
+				auto instance = static_cast<Frontend::RyInstance *>(object);
+				markObject(instance->klass);
+				for (const RyValue &value: instance->fields)
+					markValue(value);
+				break;
+			}
+			case OBJ_BOUND_METHOD: {
+				auto bound = static_cast<Frontend::RyBoundMethod *>(object);
+				markValue(bound->receiver);
+				markObject(bound->method);
+				break;
+			}
+		}
+	}
+
+	void Heap::removeUnmarkedStrings() {
+		for (auto it = strings.begin(); it != strings.end();) {
+			if (it->second->isMarked)
+				++it;
+			else
+				it = strings.erase(it);
+		}
+	}
+
+	size_t Heap::sweep() {
+		size_t freed = 0;
+		RyObject **link = &objects;
+
+		while (*link != nullptr) {
+			RyObject *object = *link;
+			if (object->isMarked) {
+				object->isMarked = false;
+				link = &object->next;
+				continue;
+			}
+
+			*link = object->next;
+			freed += object->allocatedSize;
+			freeObject(object);
+		}
+
+		bytesAllocated -= freed;
+		return freed;
+	}
+} // namespace RyRuntime
@@ -0,0 +1,25 @@
+#include "shape.h"
+
+namespace RyRuntime {
+	namespace {
+		uint32_t nextShapeId = 1; // 0 is left for empty cache entries
+	}
+
+	Shape::Shape() : id(nextShapeId++) {}
+
+	Shape::Shape(const Shape &parent, const std::string &name) : id(nextShapeId++), slots(parent.slots) {
+		slots[name] = parent.fieldCount();
+	}
+
+	int Shape::find(const std::string &name) const {
+		auto it = slots.find(name);
+		return it == slots.end() ? -1 : it->second;
+	}
+
+	Shape *Shape::withField(const std::string &name) {
+		auto &next = transitions[name];
+		if (next == nullptr)
+			next.reset(new Shape(*this, name));
+		return next.get();
+	}
+} // namespace RyRuntime
@@ -1,14 +1,17 @@
 #include "vm.h"
 #include <algorithm>
+#include <climits>
 #include <cstdio>
 #include <fstream>
 #include <set>
 #include <stdarg.h>
+#include "bytecode.h"
 #include "chunk.h"
 #include "class.h"
 #include "common.h"
 #include "compiler.h"
 #include "func.h"
+#include "globals.h"
 #include "lexer.h"
 #include "native.hpp"
 #include "parser.h"
@@ -43,18 +46,9 @@ namespace RyRuntime {
 		return prev[m];
 	}
 
-	void VM::push(RyValue value) {
-		*stackTop = value;
-		stackTop++;
-	}
-
-	RyValue VM::pop() {
-		stackTop--;
-		return *stackTop;
-	}
-	std::shared_ptr<RyUpValue> VM::captureUpvalue(RyValue *local) {
-		std::shared_ptr<RyUpValue> prevUpvalue = nullptr;
-		std::shared_ptr<RyUpValue> upvalue = openUpvalues;
+	RyUpValue *VM::captureUpvalue(RyValue *local) {
+		RyUpValue *prevUpvalue = nullptr;
+		RyUpValue *upvalue = openUpvalues;
 
 		while (upvalue != nullptr && upvalue->location > local) {
 			prevUpvalue = upvalue;
@@ -65,8 +59,7 @@ namespace RyRuntime {
 			return upvalue;
 		}
 
-		auto createdUpvalue = std::make_shared<RyUpValue>();
-		createdUpvalue->location = local;
+		auto createdUpvalue = allocateObject<RyUpValue>(local);
 		createdUpvalue->next = upvalue;
 
 		if (prevUpvalue == nullptr) {
@@ -79,16 +72,108 @@ namespace RyRuntime {
 	}
 
 	VM::VM() {
+		stackValues.resize(STACK_INITIAL);
+		stack = stackValues.data();
+		stackLimit = stack + STACK_INITIAL - 1;
+		frames.resize(FRAMES_INITIAL);
+		frameCapacity = FRAMES_INITIAL;
 		resetStack();
-		openUpvalues = nullptr;
+		heap().owner = this;
 		registerNatives(globals);
 	}
 
+	VM::~VM() {
+		if (heap().owner == this)
+			heap().owner = nullptr;
+	}
+
+	void VM::markRoots(Heap &heap) {
+		for (RyValue *slot = stack; slot < stackTop; slot++) {
+			heap.markValue(*slot);
+		}
+		for (int i = 0; i < frameCount; i++) {
+			heap.markObject(frames[i].function);
+			heap.markObject(frames[i].closure);
+		}
+		for (RyValue value: globals) {
+			heap.markValue(value);
+		}
+		for (RyUpValue *upvalue = openUpvalues; upvalue != nullptr; upvalue = upvalue->next) {
+			heap.markObject(upvalue);
+		}
+		for (auto const &[name, closure]: moduleCache) {
+			heap.markObject(closure);
+		}
+		for (auto const &[path, closure]: bundledModules) {
+			heap.markObject(closure);
+		}
+	}
+
+	std::string VM::closestGlobal(const std::string &name) {
+		std::string bestMatch = "";
+		int minDistance = 3;
+
+		for (int slot = 0; slot < (int) globals.size(); slot++) {
+			if (globals[slot].isEmpty())
+				continue;
+			const std::string &key = globalNames().nameOf(slot);
+			int dist = calculateDistance(name, key);
+			if (dist < minDistance) {
+				minDistance = dist;
+				bestMatch = key;
+			}
+		}
+		return bestMatch;
+	}
+
+	void VM::growGlobals() {
+		if ((int) globals.size() < globalNames().size())
+			globals.resize(globalNames().size(), RyValue::empty());
+	}
+
 	void VM::resetStack() {
 		stackTop = stack;
 		frameCount = 0;
 	}
 
+	void VM::setCallDepthLimit(int maxFrames) {
+		this->maxFrames = std::max(maxFrames, 1);
+		// A frame addresses at most 256 slots, so deep recursion runs into the depth limit first
+		maxValues = (int) std::clamp<long long>(256LL * this->maxFrames, STACK_MAX, INT_MAX);
+		frameCapacity = std::min((int) frames.size(), this->maxFrames);
+	}
+
+	bool VM::growStack() {
+		int capacity = (int) stackValues.size();
+		if (capacity >= maxValues)
+			return false;
+		int grownCapacity = std::min(capacity * 2, maxValues);
+
+		// Copied into a new block first, so every pointer can still be rebased against the old one
+		std::vector<RyValue> grown(grownCapacity);
+		std::copy(stack, stackTop, grown.begin());
+		RyValue *base = grown.data();
+		for (int i = 0; i < frameCount; i++)
+			frames[i].slots = base + (frames[i].slots - stack);
+		for (RyUpValue *upvalue = openUpvalues; upvalue != nullptr; upvalue = upvalue->next)
+			upvalue->location = base + (upvalue->location - stack);
+		stackTop = base + (stackTop - stack);
+
+		stackValues.swap(grown);
+		stack = base;
+		stackLimit = stack + grownCapacity - 1;
+		return true;
+	}
+
+	bool VM::growFrames() {
+		if (frameCapacity >= maxFrames)
+			return false;
+		frameCapacity = std::min(frameCapacity * 2, maxFrames);
+		if ((int) frames.size() < frameCapacity)
+			frames.resize(frameCapacity);
+		return true;
+	}
+
 	// Helper for runtime errors to show line numbers
 	void VM::runtimeError(const char *format, ...) {
 		char buffer[1024];
@@ -100,13 +185,15 @@ namespace RyRuntime {
 		push(RyValue(std::string(buffer)));
 	}
 
-	InterpretResult VM::interpret(std::shared_ptr<Frontend::RyFunction> function) {
+	InterpretResult VM::interpret(Frontend::RyFunction *function) {
 		resetStack();
+		growGlobals();
 
-		std::shared_ptr<RyClosure> closure = std::make_shared<RyClosure>(function);
+		RyClosure *closure = newClosure(function);
 		push(RyValue(closure));
 
 		CallFrame *frame = &frames[frameCount++];
+		frame->function = function;
 		frame->closure = closure;
 		frame->ip = function->chunk.code.data();
 		frame->slots = stack;
@@ -116,153 +203,609 @@ namespace RyRuntime {
 	bool VM::isTruthy(RyValue value) {
 		if (value.isNil())
 			return false;
+		if (value.isInt())
+			return value.asInt() != 0;
 		if (value.isNumber())
 			return value.asNumber() != 0;
 		if (value.isBool())
 			return value.asBool();
 		return true;
 	}
-	RyValue VM::peek(int distance) {
-		// stackTop points to the NEXT empty slot,
-		// so -1 is the current top, -2 is one below, etc.
-		return stackTop[-1 - distance];
-	}
 
 	void VM::closeUpvalues(RyValue *last) {
 		while (openUpvalues != nullptr && openUpvalues->location >= last) {
-			std::shared_ptr<RyUpValue> upvalue = openUpvalues;
+			RyUpValue *upvalue = openUpvalues;
 			upvalue->closed = *upvalue->location;
 			upvalue->location = &upvalue->closed;
 			openUpvalues = upvalue->next;
 		}
 	}
 
-	InterpretResult VM::run() {
-#define FRAME (frames[frameCount - 1])
-#define READ_BYTE() (*FRAME.ip++)
-#define READ_CONSTANT() (FRAME.closure->function->chunk.constants[READ_BYTE()])
-#define READ_SHORT() (FRAME.ip += 2, (uint16_t) ((FRAME.ip[-2] << 8) | FRAME.ip[-1]))
-#define RY_PANIC(format, ...)                                                                                          \
-	{                                                                                                                    \
-		runtimeError(format, ##__VA_ARGS__);                                                                               \
-		push(RyValue(buffer));                                                                                             \
-		goto trigger_panic;                                                                                                \
+	void VM::addBundledModule(const std::string &path, Frontend::RyFunction *function) {
+		bundledModules[path] = newClosure(function);
 	}
 
-		for (;;) {
-			// Debug: Print stack height
-			/*std::cout << "--- STACK DEBUG (Height: " << (stackTop - stack) << ") ---" << std::endl;
-			for (RyValue *slot = stack; slot < stackTop; slot++) {
-				std::cout << "[" << (slot - stack) << "]" << " Value: " << slot->to_string();
+	RyClosure *VM::loadModule(const std::string &path) {
+		auto bundled = bundledModules.find(path);
+		if (bundled != bundledModules.end())
+			return bundled->second;
+
+		std::string fileName = RyTools::findModulePath(path, false);
+
+		// Check if the module is already compiled and cached
+		auto cached = moduleCache.find(fileName);
+		if (cached != moduleCache.end()) {
+			return cached->second;
+		}
+
+		// Read the file
+		std::ifstream file(fileName);
+		if (!file.is_open()) {
+			runtimeError("Could not open script file '%s'.", fileName.c_str());
+			return nullptr;
+		}
+		std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+		// Reuse the bytecode cached next to the module when it was compiled from the same source
+		std::string cachePath = bytecodePath(fileName);
+		uint64_t sourceHash = hashSource(source);
+		Frontend::RyFunction *function = readBytecode(cachePath, sourceHash);
+
+		if (function == nullptr) {
+			// Compile the imported script
+			Backend::AstArena arena; // Every node of the tree and lexeme not in the source, freed once the chunk is compiled
+			Backend::Lexer lexer(source, arena);
+
+			// Use a temporary set for aliases if needed
+			std::set<std::string, std::less<>> tempAliases;
+			Backend::Parser parser(lexer, arena, tempAliases, source);
+			auto statements = parser.parse();
+
+			Compiler compiler = Compiler(nullptr, source);
+			Chunk chunk;
+			if (!compiler.compile(statements, &chunk)) {
+				runtimeError("Failed to compile imported script '%s'.", fileName.c_str());
+				return nullptr;
 			}
-			std::cout << "\nStack height: " << (long) (stackTop - stack) << " Frames: " << frames << std::endl;
-			std::cout << "--------------------------" << std::endl;
-			*/
-			if (stackTop < stack) {
-				runtimeError("Stack Underflow! Pointer: %p, Base: %p", stackTop, stack);
-				goto trigger_panic;
+
+			function = allocateObject<Frontend::RyFunction>(std::move(chunk), fileName, 0);
+			writeBytecode(cachePath, function, sourceHash);
+		}
+		function->name = fileName;
+
+		growGlobals();
+
+		auto closure = newClosure(function);
+		// Store the newly compiled module in the cache
+		moduleCache[fileName] = closure;
+		return closure;
+	}
+
+	// --- Integer fast paths, see RyValue::integer() for when they turn into doubles ---
+
+	static inline RyValue addInts(int64_t a, int64_t b) { return RyValue::integer(a + b); }
+	static inline RyValue subtractInts(int64_t a, int64_t b) { return RyValue::integer(a - b); }
+	static inline RyValue lessInts(int64_t a, int64_t b) { return RyValue(a < b); }
+
+	// asNumber() for a value known to be a number, by value so the operand is not spilled if run() does not inline it
+	static inline double numberOf(RyValue value) {
+		if (value.isInt())
+			return (double) value.asInt();
+		double d;
+		std::memcpy(&d, &value.bits, sizeof d);
+		return d;
+	}
+
+	// --- Operators shared by the stack and register forms, for anything that is not two numbers ---
+
+	bool VM::getProperty(RyValue object, RyValue name, PropertyCache &cache, RyValue &result) {
+		std::string propertyName(name.asString());
+
+		// Properties that REPLACE the object (like .len)
+		if (propertyName == "len") {
+			if (object.isList())
+				result = RyValue::integer(object.asList()->size());
+			else if (object.isString())
+				result = RyValue::integer(object.asString().length());
+			else if (object.isMap())
+				result = RyValue::integer(object.asMap()->size());
+			else
+				result = RyValue();
+			return true;
+		}
+
+		// If it's not a special property, check if it's a map key
+		if (object.isMap()) {
+			auto ryMap = object.asMap();
+			auto it = ryMap->find(name);
+			if (it != ryMap->end()) {
+				result = it->second;
+				return true;
+			}
+		}
+
+		if (object.isInstance()) {
+			auto instance = object.asInstance();
+			int slot = instance->shape->find(propertyName);
+			if (slot >= 0) {
+				cache.add({instance->shape->id, slot});
+				result = instance->fields[slot];
+				return true;
 			}
-			if (stackTop >= stack + STACK_MAX) {
-				runtimeError("Stack Overflow!");
-				goto trigger_panic;
+			RyClosure *method = instance->klass->findMethod(propertyName);
+			if (method != nullptr) {
+				cache.add({instance->shape->id, -1, method});
+				result = RyValue(allocateObject<Frontend::RyBoundMethod>(object, method));
+				return true;
 			}
+		}
 
-			uint8_t instruction;
-			switch (instruction = READ_BYTE()) {
-				case OP_POP: {
+		if (object.isClass()) {
+			RyClosure *method = object.asClass()->findMethod(propertyName);
+			if (method != nullptr) {
+				result = RyValue(method);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	const PropertyCache::Entry *VM::cacheFieldStore(PropertyCache &cache, Shape *shape, const std::string &name) {
+		int slot = shape->find(name);
+		if (slot >= 0)
+			return cache.add({shape->id, slot});
+		return cache.add({shape->id, shape->fieldCount(), nullptr, shape->withField(name)});
+	}
+
+	bool VM::addValues(RyValue a, RyValue b, RyValue &result) {
+		if (a.isList()) {
+			auto newList = allocateObject<RyList>(*a.asList());
+
+			if (b.isList()) {
+				auto bList = b.asList();
+				newList->insert(newList->end(), bList->begin(), bList->end());
+			} else {
+				newList->push_back(b);
+			}
+			result = RyValue(newList);
+		} else if (a.isNumber() && b.isNumber()) {
+			result = a + b;
+		} else if (a.isString()) {
+			result = RyValue(concatenate(a.asStringObject(), b.to_string()));
+		} else if (b.isString()) {
+			result = RyValue(a.to_string() + b.to_string());
+		} else {
+			runtimeError("Operands must be numbers, strings, or lists.");
+			return false;
+		}
+		return true;
+	}
+
+	bool VM::subtractValues(RyValue a, RyValue b, RyValue &result) {
+		if (a.isNumber() && b.isNumber()) {
+			result = a - b;
+			return true;
+		}
+		runtimeError("Operands must be numbers");
+		return false;
+	}
+
+	bool VM::multiplyValues(RyValue a, RyValue b, RyValue &result) {
+		if (a.isList()) {
+			auto newList = allocateObject<RyList>(*a.asList());
+
+			if (b.isList()) {
+				auto bList = b.asList();
+				newList->insert(newList->end(), bList->begin(), bList->end());
+			} else {
+				newList->push_back(b);
+			}
+			result = RyValue(newList);
+		} else if (a.isNumber() && b.isNumber()) {
+			result = a * b;
+		} else if (a.isNumber() && b.isString()) {
+			std::string repeated;
+			repeated.reserve(a.asNumber() * b.to_string().length());
+			for (size_t i = 0; i < a.asNumber(); ++i) {
+				repeated += b.to_string();
+			}
+			result = RyValue(repeated);
+		} else if (a.isString() && b.isNumber()) {
+			std::string repeated;
+			repeated.reserve(b.asNumber() * a.to_string().length());
+			for (size_t i = 0; i < b.asNumber(); ++i) {
+				repeated += a.to_string();
+			}
+			result = RyValue(repeated);
+		} else {
+			runtimeError("Operands must be numbers, strings, or lists.");
+			return false;
+		}
+		return true;
+	}
+
+	bool VM::lessValues(RyValue a, RyValue b, RyValue &result) {
+		result = a < b;
+		return true;
+	}
+
+	InterpretResult VM::run() {
+// The running frame lives in locals, frame->ip is only written back before the frame is left
+#define LOAD_FRAME()                                                                                                   \
+	frame = &frames[frameCount - 1];                                                                                     \
+	ip = frame->ip;                                                                                                      \
+	slots = frame->slots;                                                                                                \
+	constants = frame->function->chunk.constants.data();
+#define READ_BYTE() (*ip++)
+#define READ_CONSTANT() (constants[READ_BYTE()])
+#define READ_SHORT() (ip += 2, (uint16_t) ((ip[-2] << 8) | ip[-1]))
+// Collections only happen here, where every live value is reachable from the roots
+#define GC_SAFEPOINT()                                                                                                 \
+	if (heap().shouldCollect())                                                                                          \
+		heap().collect();
+// Makes room for one more value. Growing moves the stack, so nothing may hold a pointer into it across this
+#define RESERVE_SLOT()                                                                                                 \
+	if (stackTop >= stackLimit) [[unlikely]] {                                                                           \
+		if (!growStack()) {                                                                                                \
+			runtimeError("Stack Overflow!");                                                                                 \
+			goto trigger_panic;                                                                                              \
+		}                                                                                                                  \
+		slots = frame->slots;                                                                                              \
+	}
+// Only instructions that leave the stack taller than they found it can overflow it, the rest push no more than
+// they popped. A runtime error pushes its message into the slot stackLimit keeps free.
+#define PUSH_CHECKED(value)                                                                                            \
+	{                                                                                                                    \
+		RESERVE_SLOT();                                                                                                    \
+		push(value);                                                                                                       \
+	}
+// Checked before every new CallFrame, growing moves the frames
+#define CHECK_FRAMES()                                                                                                 \
+	if (frameCount == frameCapacity) [[unlikely]] {                                                                      \
+		if (!growFrames()) {                                                                                               \
+			runtimeError("Stack Overflow!");                                                                                 \
+			goto trigger_panic;                                                                                              \
+		}                                                                                                                  \
+		frame = &frames[frameCount - 1];                                                                                   \
+	}
+// Three-address form: dst, a register and a register or constant, dst may be REG_PUSH
+// The slow path writes to its own local, so result is never address-taken and stays in a register
+#define REGISTER_BINARY(readB, intOp, numberOp, slowPath)                                                              \
+	{                                                                                                                    \
+		uint8_t dst = READ_BYTE();                                                                                         \
+		RyValue a = slots[READ_BYTE()];                                                                                    \
+		RyValue b = readB;                                                                                                 \
+		RyValue result;                                                                                                    \
+		if (a.isInt() && b.isInt()) [[likely]] {                                                                           \
+			result = intOp(a.asInt(), b.asInt());                                                                            \
+		} else if (a.isNumber() && b.isNumber()) {                                                                         \
+			result = RyValue(numberOf(a) numberOp numberOf(b));                                                              \
+		} else {                                                                                                           \
+			RyValue slow;                                                                                                    \
+			if (!slowPath(a, b, slow))                                                                                       \
+				goto trigger_panic;                                                                                            \
+			result = slow;                                                                                                   \
+		}                                                                                                                  \
+		if (dst == REG_PUSH) {                                                                                             \
+			PUSH_CHECKED(result);                                                                                            \
+		} else {                                                                                                           \
+			slots[dst] = result;                                                                                             \
+		}                                                                                                                  \
+		DISPATCH();                                                                                                        \
+	}
+// Bit operations work on integers, a double is truncated first
+#define BITWISE_BINARY(op)                                                                                             \
+	{                                                                                                                    \
+		RyValue b = pop();                                                                                                 \
+		RyValue a = pop();                                                                                                 \
+		if (a.isInt() && b.isInt()) [[likely]] {                                                                           \
+			push(RyValue::integer(a.asInt() op b.asInt()));                                                                  \
+		} else if (a.isNumber() && b.isNumber()) {                                                                         \
+			push(RyValue::integer(a.toInteger() op b.toInteger()));                                                          \
+		} else {                                                                                                           \
+			runtimeError("Operands must be numbers for bitwise operations.");                                                \
+			goto trigger_panic;                                                                                              \
+		}                                                                                                                  \
+		DISPATCH();                                                                                                        \
+	}
+// A quickened guard failed: put the generic opcode back and run it, it will re-specialize if it can
+#define DEOPTIMIZE(generic)                                                                                            \
+	{                                                                                                                    \
+		ip[-1] = generic;                                                                                                  \
+		ip--;                                                                                                              \
+		DISPATCH();                                                                                                        \
+	}
+// Fused "a < b; JUMP_IF_FALSE; POP", the jump target still pops the condition so it is left what OP_LESS
+// would push: false, or null when an operand is not a number, which `and` gives back as its result
+#define JUMP_UNLESS_LESS(a, b, offset)                                                                                 \
+	{                                                                                                                    \
+		if (a.isInt() && b.isInt()) [[likely]] {                                                                           \
+			if (!(a.asInt() < b.asInt())) {                                                                                  \
+				PUSH_CHECKED(RyValue(false));                                                                                  \
+				ip += offset;                                                                                                  \
+			}                                                                                                                \
+		} else if (a.isNumber() && b.isNumber()) {                                                                         \
+			if (!(numberOf(a) < numberOf(b))) {                                                                              \
+				PUSH_CHECKED(RyValue(false));                                                                                  \
+				ip += offset;                                                                                                  \
+			}                                                                                                                \
+		} else {                                                                                                           \
+			PUSH_CHECKED(a < b);                                                                                             \
+			ip += offset;                                                                                                    \
+		}                                                                                                                  \
+		DISPATCH();                                                                                                        \
+	}
+// Threaded dispatch jumps straight to the next handler, the fallback goes back round the switch.
+// A computed goto does not run destructors, so handlers only keep trivially destructible locals in scope.
+#ifdef RY_COMPUTED_GOTO
+#define CASE(op) op_##op
+#define DEFAULT op_default
+#define DISPATCH() goto *dispatchTable[READ_BYTE()]
+#else
+#define CASE(op) case op
+#define DEFAULT default
+#define DISPATCH() continue
+#endif
+
+		CallFrame *frame;
+		uint8_t *ip;
+		RyValue *slots;
+		RyValue *constants;
+		uint8_t argCount; // Set by OP_CALL, or by OP_INVOKE before it falls back to a plain call
+		LOAD_FRAME();
+
+#ifdef RY_COMPUTED_GOTO
+		// One entry per opcode, in the same order as the OpCode enum
+		static void *dispatchTable[] = {
+				&&op_OP_CONSTANT,
+				&&op_OP_NULL,
+				&&op_OP_TRUE,
+				&&op_OP_FALSE,
+				&&op_OP_POP,
+				&&op_OP_DEFINE_GLOBAL,
+				&&op_OP_GET_GLOBAL,
+				&&op_OP_SET_GLOBAL,
+				&&op_OP_GET_LOCAL,
+				&&op_OP_SET_LOCAL,
+				&&op_OP_GET_PROPERTY,
+				&&op_OP_SET_PROPERTY,
+				&&op_OP_CLOSURE,
+				&&op_OP_GET_UPVALUE,
+				&&op_OP_SET_UPVALUE,
+				&&op_OP_ADD,
+				&&op_OP_SUBTRACT,
+				&&op_OP_MULTIPLY,
+				&&op_OP_DIVIDE,
+				&&op_OP_MODULO,
+				&&op_OP_NEGATE,
+				&&op_default, // OP_GROUPING
+				&&op_default, // OP_CLOSE_GROUPING
+				&&op_OP_BUILD_RANGE_LIST,
+				&&op_OP_BUILD_LIST,
+				&&op_OP_GET_INDEX,
+				&&op_OP_SET_INDEX,
+				&&op_OP_BITWISE_OR,
+				&&op_OP_BITWISE_XOR,
+				&&op_OP_BITWISE_AND,
+				&&op_OP_LEFT_SHIFT,
+				&&op_OP_RIGHT_SHIFT,
+				&&op_OP_COPY,
+				&&op_OP_BUILD_MAP,
+				&&op_OP_EQUAL,
+				&&op_OP_GREATER,
+				&&op_OP_LESS,
+				&&op_OP_NOT,
+				&&op_OP_JUMP,
+				&&op_OP_JUMP_IF_FALSE,
+				&&op_OP_LOOP,
+				&&op_OP_FOR_EACH_NEXT,
+				&&op_OP_CALL,
+				&&op_OP_TAIL_CALL,
+				&&op_OP_INVOKE,
+				&&op_OP_CLASS,
+				&&op_OP_METHOD,
+				&&op_OP_INHERIT,
+				&&op_OP_PANIC,
+				&&op_OP_RETURN,
+				&&op_default, // OP_FUNCTION
+				&&op_OP_ATTEMPT,
+				&&op_OP_END_ATTEMPT,
+				&&op_OP_IMPORT,
+				&&op_OP_ADD_RR,
+				&&op_OP_ADD_RK,
+				&&op_OP_SUBTRACT_RR,
+				&&op_OP_SUBTRACT_RK,
+				&&op_OP_MULTIPLY_RR,
+				&&op_OP_MULTIPLY_RK,
+				&&op_OP_LESS_RR,
+				&&op_OP_LESS_RK,
+				&&op_OP_INC_LOCAL,
+				&&op_OP_ADD_LOCAL_CONST,
+				&&op_OP_JUMP_IF_NOT_LESS,
+				&&op_OP_JUMP_IF_NOT_LESS_LOCAL_CONST,
+				&&op_OP_JUMP_IF_NOT_LESS_LOCAL_LOCAL,
+				&&op_OP_ADD_NUM_NUM,
+				&&op_OP_ADD_STR_STR,
+				&&op_OP_LESS_NUM_NUM,
+		};
+		static_assert(sizeof(dispatchTable) / sizeof(dispatchTable[0]) == OP_COUNT,
+									"dispatchTable is out of sync with OpCode");
+
+		DISPATCH();
+		{
+#else
+		for (;;) {
+			switch (READ_BYTE()) {
+#endif
+				CASE(OP_POP): {
 					pop();
-					break;
+					DISPATCH();
 				}
-				case OP_NULL: {
-					push(RyValue());
-					break;
+				CASE(OP_NULL): {
+					PUSH_CHECKED(RyValue());
+					DISPATCH();
 				}
-				case OP_TRUE: {
-					push(RyValue(true));
-					break;
+				CASE(OP_TRUE): {
+					PUSH_CHECKED(RyValue(true));
+					DISPATCH();
 				}
-				case OP_FALSE: {
-					push(RyValue(false));
-					break;
+				CASE(OP_FALSE): {
+					PUSH_CHECKED(RyValue(false));
+					DISPATCH();
 				}
 
-				case OP_CONSTANT: {
-					push(READ_CONSTANT());
-					break;
+				CASE(OP_CONSTANT): {
+					PUSH_CHECKED(READ_CONSTANT());
+					DISPATCH();
 				}
-				case OP_ADD: {
+				CASE(OP_ADD): {
 					RyValue b = pop();
 					RyValue a = pop();
 
-					if (a.isList()) {
-						auto newList = std::make_shared<std::vector<RyValue>>(*a.asList());
+					// Quicken: the next run of this instruction goes straight to the specialized handler
+					if (a.isNumber() && b.isNumber())
+						ip[-1] = OP_ADD_NUM_NUM;
+					if (a.isString() && b.isString()) {
+						ip[-1] = OP_ADD_STR_STR;
+						push(RyValue(concatenate(a.asStringObject(), b.asString())));
+						DISPATCH();
+					}
 
-						if (b.isList()) {
-							auto bList = b.asList();
-							newList->insert(newList->end(), bList->begin(), bList->end());
-						} else {
-							newList->push_back(b);
-						}
-						push(RyValue(newList));
-					} else if (a.isNumber() && b.isNumber()) {
-						push(RyValue(a.asNumber() + b.asNumber()));
-					} else if (a.isString() || b.isString()) {
-						push(RyValue(a.to_string() + b.to_string()));
-					} else {
-						runtimeError("Operands must be numbers, strings, or lists.");
+					RyValue result;
+					if (!addValues(a, b, result))
 						goto trigger_panic;
-					}
-					break;
+					push(result);
+					DISPATCH();
 				}
-				case OP_SUBTRACT: {
+				CASE(OP_SUBTRACT): {
 					RyValue b = pop();
 					RyValue a = pop();
 
+					if (a.isInt() && b.isInt()) [[likely]] {
+						push(subtractInts(a.asInt(), b.asInt()));
+						DISPATCH();
+					}
 					if (a.isNumber() && b.isNumber()) {
-						push(RyValue(a.asNumber() - b.asNumber()));
-					} else {
-						runtimeError("Operands must be numbers");
-						goto trigger_panic;
+						push(RyValue(numberOf(a) - numberOf(b)));
+						DISPATCH();
 					}
-					break;
+
+					RyValue result;
+					if (!subtractValues(a, b, result))
+						goto trigger_panic;
+					push(result);
+					DISPATCH();
 				}
-				case OP_MULTIPLY: {
+				CASE(OP_MULTIPLY): {
 					RyValue b = pop();
 					RyValue a = pop();
 
-					if (a.isList()) {
-						auto newList = std::make_shared<std::vector<RyValue>>(*a.asList());
+					if (a.isInt() && b.isInt()) [[likely]] {
+						push(RyValue::multiplyInts(a.asInt(), b.asInt()));
+						DISPATCH();
+					}
+					if (a.isNumber() && b.isNumber()) {
+						push(RyValue(numberOf(a) * numberOf(b)));
+						DISPATCH();
+					}
 
-						if (b.isList()) {
-							auto bList = b.asList();
-							newList->insert(newList->end(), bList->begin(), bList->end());
-						} else {
-							newList->push_back(b);
-						}
-						push(RyValue(newList));
-					} else if (a.isNumber() && b.isNumber()) {
-						push(RyValue(a.asNumber() * b.asNumber()));
-					} else if (a.isNumber() && b.isString()) {
-						std::string result;
-						result.reserve(a.asNumber() * b.to_string().length());
-						for (size_t i = 0; i < a.asNumber(); ++i) {
-							result += b.to_string();
-						}
-						push(RyValue(result));
-					} else if (a.isString() && b.isNumber()) {
-						std::string result;
-						result.reserve(b.asNumber() * a.to_string().length());
-						for (size_t i = 0; i < b.asNumber(); ++i) {
-							result += a.to_string();
-						}
-						push(RyValue(result));
-					} else {
-						runtimeError("Operands must be numbers, strings, or lists.");
+					RyValue result;
+					if (!multiplyValues(a, b, result))
+						goto trigger_panic;
+					push(result);
+					DISPATCH();
+				}
+				CASE(OP_ADD_RR):
+					REGISTER_BINARY(slots[READ_BYTE()], addInts, +, addValues);
+				CASE(OP_ADD_RK):
+					REGISTER_BINARY(READ_CONSTANT(), addInts, +, addValues);
+				CASE(OP_SUBTRACT_RR):
+					REGISTER_BINARY(slots[READ_BYTE()], subtractInts, -, subtractValues);
+				CASE(OP_SUBTRACT_RK):
+					REGISTER_BINARY(READ_CONSTANT(), subtractInts, -, subtractValues);
+				CASE(OP_MULTIPLY_RR):
+					REGISTER_BINARY(slots[READ_BYTE()], RyValue::multiplyInts, *, multiplyValues);
+				CASE(OP_MULTIPLY_RK):
+					REGISTER_BINARY(READ_CONSTANT(), RyValue::multiplyInts, *, multiplyValues);
+				CASE(OP_LESS_RR):
+					REGISTER_BINARY(slots[READ_BYTE()], lessInts, <, lessValues);
+				CASE(OP_LESS_RK):
+					REGISTER_BINARY(READ_CONSTANT(), lessInts, <, lessValues);
+				CASE(OP_ADD_NUM_NUM): {
+					RyValue b = stackTop[-1];
+					RyValue a = stackTop[-2];
+					if (a.isInt() && b.isInt()) [[likely]]
+						stackTop[-2] = addInts(a.asInt(), b.asInt());
+					else if (a.isNumber() && b.isNumber())
+						stackTop[-2] = RyValue(numberOf(a) + numberOf(b));
+					else
+						DEOPTIMIZE(OP_ADD);
+					stackTop--;
+					DISPATCH();
+				}
+				CASE(OP_ADD_STR_STR): {
+					RyValue b = stackTop[-1];
+					RyValue a = stackTop[-2];
+					if (!(a.isString() && b.isString()))
+						DEOPTIMIZE(OP_ADD);
+					stackTop[-2] = RyValue(concatenate(a.asStringObject(), b.asString()));
+					stackTop--;
+					DISPATCH();
+				}
+				CASE(OP_LESS_NUM_NUM): {
+					RyValue b = stackTop[-1];
+					RyValue a = stackTop[-2];
+					if (a.isInt() && b.isInt()) [[likely]]
+						stackTop[-2] = lessInts(a.asInt(), b.asInt());
+					else if (a.isNumber() && b.isNumber())
+						stackTop[-2] = RyValue(numberOf(a) < numberOf(b));
+					else
+						DEOPTIMIZE(OP_LESS);
+					stackTop--;
+					DISPATCH();
+				}
+				CASE(OP_INC_LOCAL): {
+					RyValue *local = &slots[READ_BYTE()];
+					if (local->isInt()) [[likely]] {
+						*local = addInts(local->asInt(), 1);
+					} else if (local->isNumber()) {
+						*local = RyValue(numberOf(*local) + 1);
+					} else if (!addValues(*local, RyValue::integer(1), *local)) {
 						goto trigger_panic;
 					}
-					break;
+					DISPATCH();
 				}
-				case OP_DIVIDE: {
+				CASE(OP_ADD_LOCAL_CONST): {
+					RyValue *local = &slots[READ_BYTE()];
+					RyValue constant = READ_CONSTANT();
+					if (local->isInt() && constant.isInt()) [[likely]] {
+						*local = addInts(local->asInt(), constant.asInt());
+					} else if (local->isNumber() && constant.isNumber()) {
+						*local = RyValue(numberOf(*local) + numberOf(constant));
+					} else if (!addValues(*local, constant, *local)) {
+						goto trigger_panic;
+					}
+					DISPATCH();
+				}
+				CASE(OP_JUMP_IF_NOT_LESS): {
+					uint16_t offset = READ_SHORT();
+					RyValue b = pop();
+					RyValue a = pop();
+					JUMP_UNLESS_LESS(a, b, offset);
+				}
+				CASE(OP_JUMP_IF_NOT_LESS_LOCAL_CONST): {
+					RyValue a = slots[READ_BYTE()];
+					RyValue b = READ_CONSTANT();
+					uint16_t offset = READ_SHORT();
+					JUMP_UNLESS_LESS(a, b, offset);
+				}
+				CASE(OP_JUMP_IF_NOT_LESS_LOCAL_LOCAL): {
+					RyValue a = slots[READ_BYTE()];
+					RyValue b = slots[READ_BYTE()];
+					uint16_t offset = READ_SHORT();
+					JUMP_UNLESS_LESS(a, b, offset);
+				}
+				CASE(OP_DIVIDE): {
 					RyValue b = pop();
 					RyValue a = pop();
 
@@ -274,89 +817,81 @@ namespace RyRuntime {
 					}
 
 					push(a / b);
-					break;
+					DISPATCH();
 				}
-				case OP_NEGATE: {
+				CASE(OP_NEGATE): {
 					push(-pop());
-					break;
+					DISPATCH();
 				}
-				case OP_NOT: {
+				CASE(OP_NOT): {
 					push(!pop());
-					break;
+					DISPATCH();
 				}
-				case OP_EQUAL: {
+				CASE(OP_EQUAL): {
 					RyValue b = pop();
 					RyValue a = pop();
 					push(a == b);
-					break;
+					DISPATCH();
 				}
-				case OP_GREATER: {
+				CASE(OP_GREATER): {
 					RyValue b = pop();
 					RyValue a = pop();
 					push(a > b);
-					break;
+					DISPATCH();
 				}
-				case OP_LESS: {
+				CASE(OP_LESS): {
 					RyValue b = pop();
 					RyValue a = pop();
+					if (a.isNumber() && b.isNumber())
+						ip[-1] = OP_LESS_NUM_NUM;
 					push(a < b);
-					break;
+					DISPATCH();
 				}
-				case OP_MODULO: {
+				CASE(OP_MODULO): {
 					RyValue b = pop();
 					RyValue a = pop();
 					push(a % b);
-					break;
+					DISPATCH();
 				}
-				case OP_GET_LOCAL: {
+				CASE(OP_GET_LOCAL): {
 					uint8_t slot = READ_BYTE();
-					push(FRAME.slots[slot]);
-					break;
+					PUSH_CHECKED(slots[slot]);
+					DISPATCH();
 				}
-				case OP_SET_LOCAL: {
+				CASE(OP_SET_LOCAL): {
 					uint8_t slot = READ_BYTE();
-					// Debug: FRAME.slots[slot] = *(stackTop - 1);
-					FRAME.slots[slot] = pop();
-					break;
+					slots[slot] = pop();
+					DISPATCH();
 				}
-				case OP_JUMP: {
+				CASE(OP_JUMP): {
 					uint16_t offset = READ_SHORT();
-					FRAME.ip += offset;
-					break;
+					ip += offset;
+					DISPATCH();
 				}
-				case OP_JUMP_IF_FALSE: {
+				CASE(OP_JUMP_IF_FALSE): {
 					uint16_t offset = READ_SHORT();
 					if (!isTruthy(peek(0))) {
-						FRAME.ip += offset;
+						ip += offset;
 					}
-					break;
+					DISPATCH();
 				}
-				case OP_LOOP: {
+				CASE(OP_LOOP): {
 					uint16_t offset = READ_SHORT();
-					FRAME.ip -= offset;
-					break;
+					ip -= offset;
+					GC_SAFEPOINT();
+					DISPATCH();
 				}
-				case OP_DEFINE_GLOBAL: {
-					RyValue name = READ_CONSTANT();
-					globals[name.to_string()] = pop();
-					break;
+				CASE(OP_DEFINE_GLOBAL): {
+					globals[READ_SHORT()] = pop();
+					DISPATCH();
 				}
-				case OP_GET_GLOBAL: {
-					RyValue nameValue = READ_CONSTANT();
-					std::string name = nameValue.to_string();
-					auto it = globals.find(name);
-
-					if (it == globals.end()) {
-						std::string bestMatch = "";
-						int minDistance = 3;
-
-						for (auto const &[key, val]: globals) {
-							int dist = calculateDistance(name, key);
-							if (dist < minDistance) {
-								minDistance = dist;
-								bestMatch = key;
-							}
-						}
+				CASE(OP_GET_GLOBAL): {
+					uint16_t slot = READ_SHORT();
+					RyValue value = globals[slot];
+
+					if (value.isEmpty()) {
+						const std::string &name = globalNames().nameOf(slot);
+						std::string bestMatch = closestGlobal(name);
 
 						if (!bestMatch.empty()) {
 							runtimeError("Undefined variable '%s'. Did you mean '%s'?", name.c_str(), bestMatch.c_str());
@@ -366,25 +901,15 @@ namespace RyRuntime {
 
 						goto trigger_panic;
 					}
-					push(it->second);
-					break;
+					PUSH_CHECKED(value);
+					DISPATCH();
 				}
-				case OP_SET_GLOBAL: {
-					RyValue nameValue = READ_CONSTANT();
-					std::string name = nameValue.to_string();
-					auto it = globals.find(name);
-
-					if (it == globals.end()) {
-						std::string bestMatch = "";
-						int minDistance = 3;
-
-						for (auto const &[key, val]: globals) {
-							int dist = calculateDistance(name, key);
-							if (dist < minDistance) {
-								minDistance = dist;
-								bestMatch = key;
-							}
-						}
+				CASE(OP_SET_GLOBAL): {
+					uint16_t slot = READ_SHORT();
+
+					if (globals[slot].isEmpty()) {
+						const std::string &name = globalNames().nameOf(slot);
+						std::string bestMatch = closestGlobal(name);
 
 						if (!bestMatch.empty()) {
 							runtimeError("Cannot set undefined variable '%s'. Did you mean '%s'?", name.c_str(), bestMatch.c_str());
@@ -395,23 +920,23 @@ namespace RyRuntime {
 						goto trigger_panic;
 					}
 
-					// D it->second = *(stackTop - 1);
-					it->second = pop();
-					break;
+					globals[slot] = pop();
+					DISPATCH();
 				}
-				case OP_PANIC: {
+				CASE(OP_PANIC): {
 				trigger_panic:
+					frame->ip = ip; // So the report points at the failing instruction
 					RyValue message = pop();
-					std::string output = message.isNil() ? "Unknown Panic" : message.to_string();
+					RyValue output = message.isString() ? message : RyValue(message.isNil() ? "Unknown Panic" : message.to_string());
 
 					if (panicStack.empty()) {
 						if (frameCount > 0) {
 							auto &frame = frames[frameCount - 1];
-							size_t instruction = frame.ip - frame.closure->function->chunk.code.data() - 1;
-							int line = frame.closure->function->chunk.lines[instruction];
-							int column = frame.closure->function->chunk.columns[instruction];
+							size_t instruction = frame.ip - frame.function->chunk.code.data() - 1;
+							int line = frame.function->chunk.lines[instruction];
+							int column = frame.function->chunk.columns[instruction];
 
-							RyTools::report(line, column, "", output, vmSource);
+							RyTools::report(line, column, "", output.to_string(), vmSource);
 						}
 
 						resetStack();
@@ -424,14 +949,21 @@ namespace RyRuntime {
 					frameCount = block.frameDepth;
 					stackTop = stack + block.stackDepth;
 					closeUpvalues(stackTop);
-					push(RyValue(output));
+					push(output);
 
-					FRAME.ip = FRAME.closure->function->chunk.code.data() + block.handlerIP;
-					break;
+					LOAD_FRAME();
+					ip = frame->function->chunk.code.data() + block.handlerIP;
+					DISPATCH();
 				}
-				case OP_CALL: {
-					uint8_t argCount = READ_BYTE();
+				CASE(OP_CALL): {
+					GC_SAFEPOINT();
+					argCount = READ_BYTE();
+				call_value:
 					RyValue callee = *(stackTop - 1 - argCount);
+					// Every callee but a native pushes a CallFrame
+					if (!callee.isNative()) {
+						CHECK_FRAMES();
+					}
 
 					if (callee.isNative()) {
 						try {
@@ -447,6 +979,21 @@ namespace RyRuntime {
 							runtimeError("%s", e.what());
 							goto trigger_panic;
 						}
+					} else if (callee.isFunction()) {
+						// Compiled without a closure because it captures nothing, see Compiler::visitFunctionStmt()
+						auto function = callee.asFunction();
+						if (argCount != function->arity) {
+							runtimeError("Expected %d arguments but got %d.", function->arity, argCount);
+							goto trigger_panic;
+						}
+
+						frame->ip = ip;
+						frame = &frames[frameCount++];
+						frame->function = function;
+						frame->closure = nullptr;
+						frame->ip = function->chunk.code.data();
+						frame->slots = stackTop - argCount - 1;
+						LOAD_FRAME();
 					} else if (callee.isClosure()) {
 						auto closure = callee.asClosure();
 						if (argCount != closure->function->arity) {
@@ -454,35 +1001,30 @@ namespace RyRuntime {
 							goto trigger_panic;
 						}
 
-						CallFrame *frame = &frames[frameCount++];
+						frame->ip = ip;
+						frame = &frames[frameCount++];
+						frame->function = closure->function;
 						frame->closure = closure;
 						frame->ip = closure->function->chunk.code.data();
 						frame->slots = stackTop - argCount - 1;
-					} else if (callee.isFunction()) {
-						if (argCount != callee.asFunction()->arity) {
-							runtimeError("Expected %d arguments but got %d.", callee.asFunction()->arity, argCount);
-							goto trigger_panic;
-						}
-
-						CallFrame *frame = &frames[frameCount++];
-
-						frame->closure = std::make_shared<RyClosure>(callee.asFunction());
-						frame->ip = frame->closure->function->chunk.code.data();
-						frame->slots = stackTop - argCount - 1;
+						LOAD_FRAME();
 					} else if (callee.isClass()) {
 						auto klass = callee.asClass();
-						auto instance = std::make_shared<Frontend::RyInstance>(klass);
+						auto instance = allocateObject<Frontend::RyInstance>(klass);
 						*(stackTop - argCount - 1) = RyValue(instance);
 
-						auto initializer = klass->methods.find("init");
-						if (initializer != klass->methods.end()) {
-							CallFrame *frame = &frames[frameCount++];
-							frame->closure = initializer->second;
-							frame->ip = frame->closure->function->chunk.code.data();
+						RyClosure *initializer = klass->findMethod(INIT_METHOD);
+						if (initializer != nullptr) {
+							frame->ip = ip;
+							frame = &frames[frameCount++];
+							frame->function = initializer->function;
+							frame->closure = initializer;
+							frame->ip = frame->function->chunk.code.data();
 							frame->slots = stackTop - argCount - 1;
+							LOAD_FRAME();
 
-							if (argCount != frame->closure->function->arity) {
-								runtimeError("Expected %d arguments but got %d.", frame->closure->function->arity, argCount);
+							if (argCount != frame->function->arity) {
+								runtimeError("Expected %d arguments but got %d.", frame->function->arity, argCount);
 								goto trigger_panic;
 							}
 						} else if (argCount != 0) {
@@ -493,30 +1035,124 @@ namespace RyRuntime {
 						auto bound = callee.asBoundMethod();
 						*(stackTop - argCount - 1) = bound->receiver;
 
-						CallFrame *frame = &frames[frameCount++];
+						frame->ip = ip;
+						frame = &frames[frameCount++];
+						frame->function = bound->method->function;
 						frame->closure = bound->method;
-						frame->ip = frame->closure->function->chunk.code.data();
+						frame->ip = frame->function->chunk.code.data();
 						frame->slots = stackTop - argCount - 1;
+						LOAD_FRAME();
 
-						if (argCount != frame->closure->function->arity) {
-							runtimeError("Expected %d arguments but got %d.", frame->closure->function->arity, argCount);
+						if (argCount != frame->function->arity) {
+							runtimeError("Expected %d arguments but got %d.", frame->function->arity, argCount);
 							goto trigger_panic;
 						}
 					} else {
 						runtimeError("Can only call functions and classes.");
 						goto trigger_panic;
 					}
-					break;
+					DISPATCH();
 				}
-				case OP_RETURN: {
+				CASE(OP_TAIL_CALL): {
+					GC_SAFEPOINT();
+					argCount = READ_BYTE();
+					RyValue callee = *(stackTop - 1 - argCount);
+					Frontend::RyFunction *function;
+					RyClosure *closure;
+					if (callee.isFunction()) {
+						function = callee.asFunction();
+						closure = nullptr;
+					} else if (callee.isClosure()) {
+						closure = callee.asClosure();
+						function = closure->function;
+					} else if (callee.isBoundMethod()) {
+						closure = callee.asBoundMethod()->method;
+						function = closure->function;
+						*(stackTop - argCount - 1) = callee.asBoundMethod()->receiver;
+					} else {
+						// Pushes a frame as usual, the OP_RETURN after this one passes its result on
+						goto call_value;
+					}
+					if (argCount != function->arity) {
+						runtimeError("Expected %d arguments but got %d.", function->arity, argCount);
+						goto trigger_panic;
+					}
+
+					// Nothing of this frame outlives the call, the callee and its arguments slide down over it
+					closeUpvalues(slots);
+					RyValue *callSlots = stackTop - argCount - 1;
+					for (int i = 0; i <= argCount; i++)
+						slots[i] = callSlots[i];
+					stackTop = slots + argCount + 1;
+
+					frame->function = function;
+					frame->closure = closure;
+					ip = function->chunk.code.data();
+					constants = function->chunk.constants.data();
+					DISPATCH();
+				}
+				CASE(OP_INVOKE): {
+					GC_SAFEPOINT();
+					RyValue nameValue = READ_CONSTANT();
+					argCount = READ_BYTE();
+					PropertyCache &cache = frame->function->chunk.propertyCaches[READ_SHORT()];
+					RyValue receiver = *(stackTop - 1 - argCount);
+
+					// Fast path: a method this site has already seen, the receiver is already where 'this' goes
+					if (receiver.isInstance()) {
+						const PropertyCache::Entry *entry = cache.find(receiver.asInstance()->shape->id);
+						if (entry != nullptr && entry->slot >= 0) {
+							// A field holding something callable, called like OP_CALL
+							*(stackTop - 1 - argCount) = receiver.asInstance()->fields[entry->slot];
+							goto call_value;
+						}
+						if (entry != nullptr) {
+							RyClosure *method = entry->method;
+							if (argCount != method->function->arity) {
+								runtimeError("Expected %d arguments but got %d.", method->function->arity, argCount);
+								goto trigger_panic;
+							}
+							CHECK_FRAMES();
+
+							frame->ip = ip;
+							frame = &frames[frameCount++];
+							frame->function = method->function;
+							frame->closure = method;
+							frame->ip = method->function->chunk.code.data();
+							frame->slots = stackTop - argCount - 1;
+							LOAD_FRAME();
+							DISPATCH();
+						}
+					}
+
+					// Anything else is looked up like OP_GET_PROPERTY and called like OP_CALL
+					if (nameValue.asString() == "pop") {
+						// The list stays below the native as its receiver
+						RESERVE_SLOT();
+						for (RyValue *slot = stackTop; slot > stackTop - argCount; slot--)
+							*slot = slot[-1];
+						*(stackTop - argCount) = RyValue(allocateObject<Frontend::RyNative>(ry_pop, 0));
+						stackTop++;
+					} else {
+						RyValue callee;
+						if (!getProperty(receiver, nameValue, cache, callee)) {
+							stackTop -= argCount + 1;
+							runtimeError("Property '%s' not found on type.", nameValue.to_string().c_str());
+							goto trigger_panic;
+						}
+						*(stackTop - 1 - argCount) = callee;
+					}
+					goto call_value;
+				}
+				CASE(OP_RETURN): {
 					RyValue result = pop();
-					if (FRAME.closure->function->name == "init") {
-						result = FRAME.slots[0];
+					if (frame->function->name == "init") {
+						result = slots[0];
 					}
-					closeUpvalues(FRAME.slots);
+					closeUpvalues(slots);
 
 					// Save the starting point of the frame it's are about to leave
-					RyValue *currentFrameSlots = FRAME.slots;
+					RyValue *currentFrameSlots = slots;
 
 					frameCount--;
 
@@ -530,14 +1166,15 @@ namespace RyRuntime {
 					// Reset stackTop to where the CALLEE started (popping args + callee)
 					stackTop = currentFrameSlots;
 					push(result);
-					break;
+					LOAD_FRAME();
+					DISPATCH();
 				}
-				case OP_FOR_EACH_NEXT: {
+				CASE(OP_FOR_EACH_NEXT): {
 					uint16_t offset = READ_SHORT();
 					RyValue indexValue = peek(0);
 					RyValue collectionValue = peek(1);
 
-					int index = (int) indexValue.asNumber();
+					int64_t index = indexValue.toInteger();
 
 					if (!indexValue.isNumber()) {
 						std::cerr << "\n[ENGINE ERROR] Stack Corruption Detected!" << std::endl;
@@ -557,45 +1194,53 @@ namespace RyRuntime {
 					}
 
 					if (collectionValue.isRange()) {
-						RyRange range = collectionValue.asRange();
+						RyRange *range = collectionValue.asRange();
 
 						// Calculate current value: start + index
 						// For '1 to 10', if index is 0, value is 1.
-						double current = range.start + index;
+						double current = range->start + (double) index;
 
 						// Check bounds
-						bool isInBounds = (range.start < range.end) ? (current < range.end) : (current > range.end);
+						bool isInBounds = (range->start < range->end) ? (current < range->end) : (current > range->end);
 
 						if (isInBounds) {
-							*(stackTop - 1) = RyValue((double) (index + 1));
-							push(RyValue((double) current));
+							*(stackTop - 1) = RyValue::integer(index + 1);
+							PUSH_CHECKED(range->integers ? RyValue::integer((int64_t) range->start + index) : RyValue(current));
 						} else {
-							FRAME.ip += offset;
+							ip += offset;
 						}
 					} else if (collectionValue.isList()) {
 						auto list = collectionValue.asList();
-						if (index < list->size()) {
-							*(stackTop - 1) = RyValue((double) (index + 1));
-							push((*list)[index]);
+						if (index >= 0 && (size_t) index < list->size()) {
+							*(stackTop - 1) = RyValue::integer(index + 1);
+							PUSH_CHECKED((*list)[index]);
 						} else {
-							FRAME.ip += offset;
+							ip += offset;
+						}
+					} else if (collectionValue.isString()) {
+						RyString *string = collectionValue.asStringObject();
+						if (index >= 0 && (size_t) index < string->length) {
+							*(stackTop - 1) = RyValue::integer(index + 1);
+							PUSH_CHECKED(RyValue(sliceString(string, index, 1)));
+						} else {
+							ip += offset;
 						}
 					} else {
-						runtimeError("Can only use 'each' on lists or ranges.");
+						runtimeError("Can only use 'each' on lists, ranges or strings.");
 						goto trigger_panic;
 					}
-					break;
+					DISPATCH();
 				}
-				case OP_BUILD_RANGE_LIST: {
+				CASE(OP_BUILD_RANGE_LIST): {
 					double end = pop().asNumber();
 					double start = pop().asNumber();
-					push(RyValue(RyRange{start, end}));
-					break;
+					push(RyValue(allocateObject<RyRange>(start, end)));
+					DISPATCH();
 				}
 
-				case OP_BUILD_LIST: {
+				CASE(OP_BUILD_LIST): {
 					uint8_t count = READ_BYTE();
-					auto listVec = std::make_shared<std::vector<RyValue>>();
+					auto listVec = allocateObject<RyList>();
 
 					// Elements are on stack in order, but we pop them in reverse
 					// A simple way is to pre-size and fill from the end
@@ -604,42 +1249,43 @@ namespace RyRuntime {
 						(*listVec)[i] = pop();
 					}
 
-					push(RyValue(listVec));
-					break;
+					PUSH_CHECKED(RyValue(listVec)); // [] pops nothing, so it leaves the stack taller
+					DISPATCH();
 				}
-				case OP_ATTEMPT: {
+				CASE(OP_ATTEMPT): {
 					uint16_t jumpOffset = READ_SHORT();
 					ControlBlock block;
 					block.stackDepth = (int) (stackTop - stack);
 					block.frameDepth = frameCount;
 
-					block.handlerIP = (int) ((FRAME.ip + jumpOffset) - FRAME.closure->function->chunk.code.data());
+					block.handlerIP = (int) ((ip + jumpOffset) - frame->function->chunk.code.data());
 
 					panicStack.push_back(block);
-					break;
+					DISPATCH();
 				}
-				case OP_INHERIT: {
-					RyValue superclassValue = peek(1);
+				CASE(OP_INHERIT): {
+					RyValue superclassValue = peek(0);
 					if (!superclassValue.isClass()) {
 						runtimeError("Superclass must be a class.");
 						goto trigger_panic;
 					}
 
-					auto subclass = peek(0).asClass();
+					auto subclass = peek(1).asClass();
 					subclass->superclass = superclassValue.asClass();
+					subclass->vtable = subclass->superclass->vtable; // Copy-down, OP_METHOD then overrides entries
 					pop(); // Pop the superclass, leave the subclass for OP_METHOD
-					break;
+					DISPATCH();
 				}
-				case OP_END_ATTEMPT: {
+				CASE(OP_END_ATTEMPT): {
 					if (!panicStack.empty()) {
 						panicStack.pop_back();
 					} else {
 						runtimeError("Cannot end attempt if panicStack is empty.");
 						goto trigger_panic;
 					}
-					break;
+					DISPATCH();
 				}
-				case OP_GET_INDEX: {
+				CASE(OP_GET_INDEX): {
 					RyValue index = pop();
 					RyValue object = pop();
 
@@ -650,8 +1296,8 @@ namespace RyRuntime {
 							runtimeError("List index must be a number.");
 							goto trigger_panic;
 						}
-						int i = (int) index.asNumber();
-						if (i >= 0 && i < list->size()) {
+						int64_t i = index.toInteger();
+						if (i >= 0 && (size_t) i < list->size()) {
 							push((*list)[i]);
 						} else {
 							runtimeError("List index out of bounds.");
@@ -667,14 +1313,14 @@ namespace RyRuntime {
 							goto trigger_panic;
 						}
 					} else if (object.isString()) {
-						auto str = object.to_string();
 						if (!index.isNumber()) {
 							runtimeError("String index must be a number.");
 							goto trigger_panic;
 						}
-						int i = (int) index.asNumber();
-						if (i >= 0 && i < str.length()) {
-							push(RyValue(std::string(1, str[i])));
+						RyString *string = object.asStringObject();
+						int64_t i = index.toInteger();
+						if (i >= 0 && (size_t) i < string->length) {
+							push(RyValue(sliceString(string, i, 1)));
 						} else {
 							runtimeError("String index out of bounds.");
 							goto trigger_panic;
@@ -683,120 +1329,87 @@ namespace RyRuntime {
 						runtimeError("Can only index lists, maps, and strings.");
 						goto trigger_panic;
 					}
-					break;
+					DISPATCH();
 				}
-				case OP_GET_UPVALUE: {
+				CASE(OP_GET_UPVALUE): {
 					uint8_t slot = READ_BYTE();
-					push(*frames[frameCount - 1].closure->upvalues[slot]->location);
-					break;
+					PUSH_CHECKED(*frame->closure->upvalues()[slot]->location);
+					DISPATCH();
 				}
-				case OP_SET_UPVALUE: {
+				CASE(OP_SET_UPVALUE): {
 					uint8_t slot = READ_BYTE();
-					*FRAME.closure->upvalues[slot]->location = peek(0);
-					break;
+					*frame->closure->upvalues()[slot]->location = peek(0);
+					DISPATCH();
 				}
-				case OP_CLOSURE: {
-					std::shared_ptr<Frontend::RyFunction> function = READ_CONSTANT().asFunction();
+				CASE(OP_CLOSURE): {
+					Frontend::RyFunction *function = READ_CONSTANT().asFunction();
 
-					auto closure = std::make_shared<RyClosure>(function);
-					push(RyValue(closure));
+					auto closure = newClosure(function);
+					PUSH_CHECKED(RyValue(closure));
 
 					for (int i = 0; i < function->upvalueCount; i++) {
 						uint8_t isLocal = READ_BYTE();
 						uint8_t index = READ_BYTE();
 
 						if (isLocal) {
-							closure->upvalues[i] = captureUpvalue(FRAME.slots + index);
+							closure->upvalues()[i] = captureUpvalue(slots + index);
 						} else {
-							closure->upvalues[i] = FRAME.closure->upvalues[index];
+							closure->upvalues()[i] = frame->closure->upvalues()[index];
 						}
 					}
-					break;
+					DISPATCH();
 				}
-				case OP_CLASS: {
+				CASE(OP_CLASS): {
 					RyValue name = READ_CONSTANT();
-					auto klass = std::make_shared<Frontend::RyClass>(name.to_string());
-					push(RyValue(klass));
-					break;
+					auto klass = allocateObject<Frontend::RyClass>(name.to_string());
+					PUSH_CHECKED(RyValue(klass));
+					DISPATCH();
 				}
-				case OP_METHOD: {
-					RyValue name = READ_CONSTANT();
+				CASE(OP_METHOD): {
+					uint16_t symbol = READ_SHORT();
 					RyValue method = peek(0);
 					RyValue klass = peek(1);
-					auto closure = method.asClosure();
-					klass.asClass()->methods[name.to_string()] = closure;
+					klass.asClass()->setMethod(symbol, method.asClosure());
 					pop();
-					break;
+					DISPATCH();
 				}
-				case OP_GET_PROPERTY: {
+				CASE(OP_GET_PROPERTY): {
 					RyValue nameValue = READ_CONSTANT();
-					std::string propertyName = nameValue.to_string();
-
+					PropertyCache &cache = frame->function->chunk.propertyCaches[READ_SHORT()];
 					RyValue object = peek(0);
 
-					// Handle properties that REPLACE the object (like .len)
-					if (propertyName == "len") {
-						pop(); // Now we can safely remove the list
-						if (object.isList())
-							push(RyValue((double) object.asList()->size()));
-						else if (object.isString())
-							push(RyValue((double) object.to_string().length()));
-						else if (object.isMap())
-							push(RyValue((double) object.asMap()->size()));
-						break;
-					}
-
-					// Handle methods (the object stays on the stack as the 'receiver')
-					if (propertyName == "pop") {
-						// We leave the list at peek(0) and push the function on top
-						auto nativeObj = std::make_shared<Frontend::RyNative>(ry_pop, 0);
-						push(RyValue(nativeObj));
-						break;
-					}
-
-					// If it's not a special property, check if it's a map key
-					if (object.isMap()) {
-						auto ryMap = object.asMap();
-						auto it = ryMap->find(nameValue);
-						if (it != ryMap->end()) {
-							pop(); // Remove the map
-							push(it->second); // Push the value found
-							break;
-						}
-					}
-
+					// Fast path: a shape this site has already seen
 					if (object.isInstance()) {
 						auto instance = object.asInstance();
-						if (instance->fields.count(propertyName)) {
-							pop(); // Instance
-							push(instance->fields[propertyName]);
-							break;
-						}
-						auto method = instance->klass->methods.find(propertyName);
-						if (method != instance->klass->methods.end()) {
-							pop(); // Instance
-							auto bound = std::make_shared<Frontend::RyBoundMethod>(object, method->second);
-							push(RyValue(bound));
-							break;
+						const PropertyCache::Entry *entry = cache.find(instance->shape->id);
+						if (entry != nullptr) {
+							if (entry->slot >= 0)
+								stackTop[-1] = instance->fields[entry->slot];
+							else
+								stackTop[-1] = RyValue(allocateObject<Frontend::RyBoundMethod>(object, entry->method));
+							DISPATCH();
 						}
 					}
 
-					if (object.isClass()) {
-						auto klass = object.asClass();
-						auto it = klass->methods.find(propertyName);
-						if (it != klass->methods.end()) {
-							pop();
-							push(it->second);
-							break;
-						}
+					// Handle methods (the object stays on the stack as the 'receiver')
+					if (nameValue.asString() == "pop") {
+						// We leave the list at peek(0) and push the function on top
+						auto nativeObj = allocateObject<Frontend::RyNative>(ry_pop, 0);
+						PUSH_CHECKED(RyValue(nativeObj));
+						DISPATCH();
 					}
 
-					// If we found nothing, pop the object before throwing the error
-					pop();
-					runtimeError("Property '%s' not found on type.", propertyName.c_str());
-					goto trigger_panic;
+					RyValue value;
+					if (!getProperty(object, nameValue, cache, value)) {
+						// If we found nothing, pop the object before throwing the error
+						pop();
+						runtimeError("Property '%s' not found on type.", nameValue.to_string().c_str());
+						goto trigger_panic;
+					}
+					stackTop[-1] = value; // Replaces the object
+					DISPATCH();
 				}
-				case OP_SET_INDEX: {
+				CASE(OP_SET_INDEX): {
 					RyValue value = pop();
 					RyValue index = pop();
 					RyValue object = pop();
@@ -808,7 +1421,7 @@ namespace RyRuntime {
 							runtimeError("List index must be a number.");
 							goto trigger_panic;
 						}
-						(*list)[(int) index.asNumber()] = value;
+						(*list)[index.toInteger()] = value;
 						// D push(value);
 					} else if (object.isString()) {
 						runtimeError("Strings are immutable and do not support index assignment.");
@@ -822,107 +1435,53 @@ namespace RyRuntime {
 						runtimeError("Only lists support index assignment.");
 						goto trigger_panic;
 					}
-					break;
+					DISPATCH();
 				}
-				case OP_SET_PROPERTY: {
+				CASE(OP_SET_PROPERTY): {
 					RyValue nameVal = READ_CONSTANT();
+					PropertyCache &cache = frame->function->chunk.propertyCaches[READ_SHORT()];
 					RyValue value = pop();
 					RyValue object = peek(0);
 
-					if (object.isInstance()) {
-						auto instance = object.asInstance();
-						instance->fields[nameVal.to_string()] = value;
-						pop(); // Object
-						push(value);
-					} else {
+					if (!object.isInstance()) {
 						runtimeError("Only instances have fields.");
 						goto trigger_panic;
 					}
-					break;
-				}
-
-				case OP_BITWISE_AND: {
-					RyValue b = pop();
-					RyValue a = pop();
-
-					// Ensure that they are numbers to avoid crashing
-					if (!a.isNumber() || !b.isNumber()) {
-						runtimeError("Operands must be numbers for bitwise operations.");
-						goto trigger_panic;
-					}
-
-					// Cast to integers for the C++ bitwise & operator
-					long result = (long) a.asNumber() & (long) b.asNumber();
-					push(RyValue((double) result));
-					break;
-				}
-				case OP_BITWISE_OR: {
-					RyValue b = pop();
-					RyValue a = pop();
-
-					// Ensure that they are numbers to avoid crashing
-					if (!a.isNumber() || !b.isNumber()) {
-						runtimeError("Operands must be numbers for bitwise operations.");
-						goto trigger_panic;
-					}
 
-					// Cast to integers for the C++ bitwise | operator
-					long result = (long) a.asNumber() | (long) b.asNumber();
-					push(RyValue((double) result));
-					break;
-				}
-				case OP_BITWISE_XOR: {
-					RyValue b = pop();
-					RyValue a = pop();
+					auto instance = object.asInstance();
+					Shape *shape = instance->shape;
+					const PropertyCache::Entry *entry = cache.find(shape->id);
+					if (entry == nullptr)
+						entry = cacheFieldStore(cache, shape, nameVal.to_string());
 
-					// Ensure that they are numbers to avoid crashing
-					if (!a.isNumber() || !b.isNumber()) {
-						runtimeError("Operands must be numbers for bitwise operations.");
-						goto trigger_panic;
+					if (entry->transition != nullptr) {
+						// A new field always takes the next slot
+						instance->shape = entry->transition;
+						instance->fields.push_back(value);
+					} else {
+						instance->fields[entry->slot] = value;
 					}
-
-					// Cast to integers for the C++ bitwise ^ operator
-					long result = (long) a.asNumber() ^ (long) b.asNumber();
-					push(RyValue((double) result));
-					break;
+					stackTop[-1] = value; // Replaces the object
+					DISPATCH();
 				}
-				case OP_LEFT_SHIFT: {
-					RyValue b = pop();
-					RyValue a = pop();
 
-					// Ensure that they are numbers to avoid crashing
-					if (!a.isNumber() || !b.isNumber()) {
-						runtimeError("Operands must be numbers for bitwise operations.");
-						goto trigger_panic;
-					}
-
-					// Cast to integers for the C++ bitwise << operator
-					long result = (long) a.asNumber() << (long) b.asNumber();
-					push(RyValue((double) result));
-					break;
+				CASE(OP_BITWISE_AND):
+					BITWISE_BINARY(&);
+				CASE(OP_BITWISE_OR):
+					BITWISE_BINARY(|);
+				CASE(OP_BITWISE_XOR):
+					BITWISE_BINARY(^);
+				CASE(OP_LEFT_SHIFT):
+					BITWISE_BINARY(<<);
+				CASE(OP_RIGHT_SHIFT):
+					BITWISE_BINARY(>>);
+				CASE(OP_COPY): {
+					PUSH_CHECKED(peek(0));
+					DISPATCH();
 				}
-				case OP_RIGHT_SHIFT: {
-					RyValue b = pop();
-					RyValue a = pop();
-
-					// Ensure that they are numbers to avoid crashing
-					if (!a.isNumber() || !b.isNumber()) {
-						runtimeError("Operands must be numbers for bitwise operations.");
-						goto trigger_panic;
-					}
-
-					// Cast to integers for the C++ bitwise >> operator
-					long result = (long) a.asNumber() >> (long) b.asNumber();
-					push(RyValue((double) result));
-					break;
-				}
-				case OP_COPY: {
-					push(peek(0));
-					break;
-				}
-				case OP_BUILD_MAP: {
+				CASE(OP_BUILD_MAP): {
 					uint8_t count = READ_BYTE();
-					auto mapPtr = std::make_shared<std::unordered_map<RyValue, RyValue, RyValueHasher>>();
+					auto mapPtr = allocateObject<RyMap>();
 
 					for (int i = 0; i < count; i++) {
 						RyValue value = pop();
@@ -930,81 +1489,59 @@ namespace RyRuntime {
 						(*mapPtr)[key] = value;
 					}
 
-					push(RyValue(mapPtr));
-					break;
+					PUSH_CHECKED(RyValue(mapPtr)); // So does {}
+					DISPATCH();
 				}
-				case OP_IMPORT: {
+				CASE(OP_IMPORT): {
 					RyValue fileNameValue = pop();
 					if (!fileNameValue.isString()) {
 						runtimeError("Import path must be a string.");
 						goto trigger_panic;
 					}
-					std::string fileName = RyTools::findModulePath(fileNameValue.to_string(), false);
-
-					// Check if the module is already compiled and cached
-					auto cached = moduleCache.find(fileName);
-					if (cached != moduleCache.end()) {
-						// Found in cache, push it and call it.
-						push(RyValue(cached->second));
-
-						CallFrame *frame = &frames[frameCount++];
-						frame->closure = cached->second;
-						frame->ip = frame->closure->function->chunk.code.data();
-						frame->slots = stackTop - 1;
-						break; // Done with this opcode
-					}
 
-					// Read the file
-					std::ifstream file(fileName);
-					if (!file.is_open()) {
-						runtimeError("Could not open script file '%s'.", fileName.c_str());
+					RyClosure *closure = loadModule(fileNameValue.to_string());
+					if (closure == nullptr)
 						goto trigger_panic;
-					}
-					std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-
-					// Compile the imported script
-					Backend::Lexer lexer(source);
-					auto tokens = lexer.scanTokens();
 
-					// Use a temporary set for aliases if needed
-					std::set<std::string> tempAliases;
-					Backend::Parser parser(tokens, tempAliases, source);
-					auto statements = parser.parse();
+					PUSH_CHECKED(RyValue(closure));
+					CHECK_FRAMES();
 
-					Compiler compiler = Compiler(nullptr, source);
-					Chunk chunk;
-					if (!compiler.compile(statements, &chunk)) {
-						runtimeError("Failed to compile imported script '%s'.", fileName.c_str());
-						goto trigger_panic;
-					}
-
-					// Execute the script immediately
-					auto function = std::make_shared<Frontend::RyFunction>(std::move(chunk), fileName, 0);
-
-					auto closure = std::make_shared<RyClosure>(function);
-					// Store the newly compiled module in the cache
-					moduleCache[fileName] = closure;
-
-					push(RyValue(closure));
-
-					CallFrame *frame = &frames[frameCount++];
+					frame->ip = ip;
+					frame = &frames[frameCount++];
+					frame->function = closure->function;
 					frame->closure = closure; // Assign the closure object
 					frame->ip = closure->function->chunk.code.data();
 					frame->slots = stackTop - 1;
+					LOAD_FRAME();
 
 					// The VM will now continue running the code inside the imported file
 					// before returning to the original script.
-					break;
+					DISPATCH();
 				}
-				default:
+				DEFAULT:
 					return INTERPRET_COMPILE_ERROR;
+#ifdef RY_COMPUTED_GOTO
+		}
+#else
 			}
 		}
+#endif
 
-#undef FRAME
+#undef LOAD_FRAME
 #undef READ_BYTE
 #undef READ_CONSTANT
 #undef READ_SHORT
+#undef GC_SAFEPOINT
+#undef RESERVE_SLOT
+#undef PUSH_CHECKED
+#undef REGISTER_BINARY
+#undef BITWISE_BINARY
+#undef JUMP_UNLESS_LESS
+#undef DEOPTIMIZE
+#undef CHECK_FRAMES
+#undef CASE
+#undef DEFAULT
+#undef DISPATCH
 	}
 
 } // namespace RyRuntime